@@ -0,0 +1,3 @@
+0000  A2  05
+0002  F1  00 00
+0005  C2
@@ -0,0 +1,8 @@
+DATV 1
+03
+HDRM
+H SBR1 0 6
+D AD5 0
+R YY
+MV YY 1
+03
@@ -3,6 +3,12 @@
 
 #include <stdio.h>
 
+// Batch mode (fmemopen/open_memstream, pread/pwrite) and pwrite patching in
+// streaming mode need POSIX; native Windows builds use the plain file path
+#if defined(__unix__) || defined(__APPLE__)
+#define ASM_HAVE_POSIX 1
+#endif
+
 
 
 typedef enum {
@@ -52,6 +58,39 @@ struct HDRMTable {
     int  address;
 };
 
+// Expression graph node: an EQU definition, or a patch site whose operand
+// expression (TABLE+4, END-START) could not be evaluated in Pass 1.
+// Pending nodes are evaluated once, in dependency order, by finalize_pass1.
+enum { EXPR_PENDING = 0, EXPR_VISITING, EXPR_DONE, EXPR_ERROR };
+
+struct ExprTable {
+    char symbol[10];   // EQU name, "" for a patch site
+    char expr[32];
+    int  address;      // patch site LC
+    int  nbytes;       // operand bytes at the site (1 = immediate, 2 = address)
+    int  dat_site;     // DAT address if the site is direct, else -1
+    int  immediate;    // 1 = # operand, which must stay absolute
+    int  value;
+    int  reloc;        // 1 = relocatable, 0 = absolute
+    int  state;
+};
+
+// Literal pool entry (=value operands); symbol is the canonical "=value"
+// name used by FRT sites. Entries stay in LITT once placed at LTORG or END,
+// so later uses share them without taking Symbol Table slots.
+struct LiteralTable {
+    char symbol[10];
+    int  value;
+    int  address;      // pool address once placed
+    int  placed;
+};
+
+struct LineNumTable {
+    int address;
+    int line;
+    int size;          // instruction bytes
+};
+
 struct Memory {
     int  address;
     char symbol[2];
@@ -61,12 +100,21 @@ extern struct SymbolTable     ST[10];
 extern struct ForwardRefTable FRT[20];
 extern struct DirectAdrTable  DAT[30];
 extern struct HDRMTable       HDRMT[20];
+extern struct ExprTable       EXPT[20];
+extern struct LineNumTable    LNT[500];
+extern struct LiteralTable    LITT[20];
+extern int lnt_count;
+extern int lnt_overflow;
 extern struct Memory          M[500];
 
 extern int LC;
 extern char module_name[10];
 extern int prog_start;
 extern int prog_len;
+extern int compact_tab;
+extern int emit_lines;
+extern char source_file[64];
+extern int addr_bytes;
 
 int get_next_parsed_line(FILE *fp, ParsedLine *out_pl);
 void reset_parser(void);
@@ -75,10 +123,55 @@ void display_parsed_line(const ParsedLine *pl);
 void init_pass1(void);
 void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout);
 void finalize_pass1(FILE *sout);
+void write_code_line(FILE *f, int lc, const char *op, int value, int nbytes);
+int  find_symbol_address(const char *label);
+int  find_literal_address(const char *symbol);
+int  is_absolute_equ(const char *symbol);
+void remove_dat(int address);
+
+// Streaming assembly (stream.c): Pass 1 writes the .o file directly and
+// forward references become fix-ups applied with pwrite at the end
+extern int stream_mode;
+extern int stream_budget;
+int  stream_begin(FILE *fobj);
+int  stream_add_fixup(const char *symbol, int expr_idx, int lc, int nbytes);
+int  stream_finish(void);
 
 void run_pass2(FILE *sin, FILE *fobj, FILE *ftab);
 
+// .t file encoding (tabfile.c)
+// Record callback: code is 'A' (DAT entry), 'H', 'D', 'R' or 'M'.
+// For 'H', address is the start and value is the program length.
+// 'W' follows 'H' for wide modules, with the address width in bits as address.
+typedef void (*TabRecordFn)(char code, const char *symbol, int address, int value, void *ctx);
+
+void write_dat_compact(FILE *ftab, int *addrs, int n);
+void write_mrec_compact(FILE *ftab, const char *symbol, int *addrs, int n);
+int  tab_sweep(FILE *ftab, TabRecordFn fn, void *ctx);
+void write_line_table(FILE *ftab, const char *file, const int *addrs, const int *lines,
+                      const int *sizes, int n);
 
+// Decoded LINES section of a .t file, sorted by address
+typedef struct {
+    char  file[64];
+    int   count;
+    int  *address;
+    int  *line;
+    int  *size;
+} LineTable;
+
+int  tab_read_lines(FILE *ftab, LineTable *lt);
+int  line_table_lookup(const LineTable *lt, int address);
+void line_table_free(LineTable *lt);
+
+
+// Batched file I/O (batchio.c): io_uring when available, read/write otherwise
+int   bio_init(void);
+void  bio_prefetch(const char *path);
+void  bio_submit(void);
+char *bio_take(const char *path, size_t *len);
+void  bio_write(const char *path, char *data, size_t len);
+int   bio_finish(void);
 
 typedef struct {
     char mnemonic[8];
@@ -0,0 +1,367 @@
+#define _GNU_SOURCE
+#include "asm_common.h"
+
+#ifdef ASM_HAVE_POSIX
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/**
+ * Batched file I/O for multi-module runs
+ *
+ * Whole-file reads and writes are queued as io_uring operations and handed
+ * to the kernel in one io_uring_enter() per batch, so reading the next group
+ * of sources and writing finished .s/.o/.t files overlaps with assembly.
+ * Opens and closes stay synchronous; a short read or write is completed with
+ * pread/pwrite.
+ *
+ * When io_uring is not available (no kernel header at build time, or
+ * io_uring_setup fails at run time) every call falls back to plain
+ * open/read/write, done immediately. Without POSIX the file is empty and
+ * main assembles the inputs one by one.
+ */
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define BIO_HAVE_URING 1
+#endif
+#endif
+
+#ifdef BIO_HAVE_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#define BIO_MAX     64      // operations in flight
+#define BIO_ENTRIES 64      // submission queue size
+
+enum { BIO_FREE = 0, BIO_QUEUED, BIO_DONE };
+enum { BIO_READ = 1, BIO_WRITE };
+
+typedef struct {
+    char   path[264];
+    int    fd;
+    int    kind;
+    int    state;
+    int    failed;
+    char  *buf;
+    size_t len;
+} BioOp;
+
+static BioOp ops[BIO_MAX];
+static int   use_uring = 0;
+static int   write_errors = 0;
+
+// --- Synchronous helpers (fallback and short transfers) ---
+
+static int read_rest(int fd, char *buf, size_t len, size_t done) {
+    while (done < len) {
+        ssize_t n = pread(fd, buf + done, len - done, done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return 0;
+}
+
+static int write_rest(int fd, const char *buf, size_t len, size_t done) {
+    while (done < len) {
+        ssize_t n = pwrite(fd, buf + done, len - done, done);
+        if (n < 0) return -1;
+        done += n;
+    }
+    return 0;
+}
+
+static int open_for_read(const char *path, char **buf, size_t *len) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat sb;
+    if (fstat(fd, &sb) < 0) {
+        close(fd);
+        return -1;
+    }
+    *len = sb.st_size;
+    *buf = malloc(*len + 1);
+    if (!*buf) {
+        close(fd);
+        return -1;
+    }
+    (*buf)[*len] = '\0';
+    return fd;
+}
+
+// --- io_uring ---
+
+#ifdef BIO_HAVE_URING
+
+// Completes an operation; a failed or short transfer (e.g. a kernel without
+// IORING_OP_READ/WRITE) is retried synchronously from where it stopped
+static void finish_op(BioOp *o, long res) {
+    size_t done = res > 0 ? (size_t)res : 0;
+    int err = 0;
+
+    if (o->kind == BIO_READ) {
+        if (done < o->len) err = read_rest(o->fd, o->buf, o->len, done);
+        close(o->fd);
+        o->failed = err;
+        o->state = BIO_DONE;
+    } else {
+        if (done < o->len) err = write_rest(o->fd, o->buf, o->len, done);
+        close(o->fd);
+        if (err) {
+            fprintf(stderr, "ERROR: Cannot write '%s'\n", o->path);
+            write_errors++;
+        }
+        free(o->buf);
+        o->state = BIO_FREE;
+    }
+}
+
+static int ring_fd = -1;
+static unsigned *sq_head, *sq_tail, *sq_mask, *sq_array, sq_entries;
+static unsigned *cq_head, *cq_tail, *cq_mask;
+static struct io_uring_sqe *sqes;
+static struct io_uring_cqe *cqes;
+static unsigned pending_submit = 0;
+
+static int uring_setup(void) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    ring_fd = (int)syscall(__NR_io_uring_setup, BIO_ENTRIES, &p);
+    if (ring_fd < 0) return -1;
+
+    size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+
+    char *sq = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring_fd, IORING_OFF_SQ_RING);
+    char *cq = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring_fd, IORING_OFF_CQ_RING);
+    sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sq == MAP_FAILED || cq == MAP_FAILED || sqes == MAP_FAILED) {
+        close(ring_fd);
+        ring_fd = -1;
+        return -1;
+    }
+
+    sq_head  = (unsigned *)(sq + p.sq_off.head);
+    sq_tail  = (unsigned *)(sq + p.sq_off.tail);
+    sq_mask  = (unsigned *)(sq + p.sq_off.ring_mask);
+    sq_array = (unsigned *)(sq + p.sq_off.array);
+    sq_entries = p.sq_entries;
+    cq_head  = (unsigned *)(cq + p.cq_off.head);
+    cq_tail  = (unsigned *)(cq + p.cq_off.tail);
+    cq_mask  = (unsigned *)(cq + p.cq_off.ring_mask);
+    cqes     = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    return 0;
+}
+
+// Submits queued SQEs and, if min_complete > 0, waits for completions
+static void uring_enter(unsigned min_complete) {
+    if (pending_submit == 0 && min_complete == 0) return;
+    long n = syscall(__NR_io_uring_enter, ring_fd, pending_submit, min_complete,
+                     min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    if (n > 0) pending_submit -= (unsigned)n;
+}
+
+static void uring_reap(void) {
+    unsigned head = *cq_head;
+    while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe *c = &cqes[head & *cq_mask];
+        finish_op(&ops[c->user_data], c->res);
+        head++;
+    }
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+}
+
+static void uring_queue(int idx) {
+    BioOp *o = &ops[idx];
+    unsigned tail = *sq_tail;
+
+    // Submission queue full: hand the batch to the kernel first
+    while (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+        uring_enter(0);
+        uring_reap();
+    }
+
+    unsigned slot = tail & *sq_mask;
+    struct io_uring_sqe *sqe = &sqes[slot];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (o->kind == BIO_READ) ? IORING_OP_READ : IORING_OP_WRITE;
+    sqe->fd = o->fd;
+    sqe->addr = (unsigned long)o->buf;
+    sqe->len = (unsigned)o->len;
+    sqe->off = 0;
+    sqe->user_data = (unsigned)idx;
+    sq_array[slot] = slot;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    pending_submit++;
+}
+#endif
+
+// --- Public API ---
+
+int bio_init(void) {
+    memset(ops, 0, sizeof(ops));
+    write_errors = 0;
+#ifdef BIO_HAVE_URING
+    if (ring_fd >= 0 || uring_setup() == 0) use_uring = 1;
+#endif
+    return use_uring;
+}
+
+// Returns a free slot, waiting for in-flight operations if needed;
+// -1 when every slot holds a finished read that was not taken yet
+static int alloc_op(void) {
+    for (;;) {
+        int queued = 0;
+        for (int i = 0; i < BIO_MAX; i++) {
+            if (ops[i].state == BIO_FREE) return i;
+            if (ops[i].state == BIO_QUEUED) queued = 1;
+        }
+        if (!queued) return -1;
+#ifdef BIO_HAVE_URING
+        uring_enter(1);
+        uring_reap();
+#endif
+    }
+}
+
+static int find_read(const char *path) {
+    for (int i = 0; i < BIO_MAX; i++)
+        if (ops[i].state != BIO_FREE && ops[i].kind == BIO_READ && strcmp(ops[i].path, path) == 0)
+            return i;
+    return -1;
+}
+
+void bio_prefetch(const char *path) {
+    if (!use_uring || find_read(path) >= 0) return;
+#ifdef BIO_HAVE_URING
+    char *buf;
+    size_t len;
+    int fd = open_for_read(path, &buf, &len);
+    if (fd < 0) return;     // reported by bio_take
+
+    int idx = alloc_op();
+    if (idx < 0) {
+        close(fd);
+        free(buf);
+        return;
+    }
+    BioOp *o = &ops[idx];
+    strncpy(o->path, path, sizeof(o->path) - 1);
+    o->path[sizeof(o->path) - 1] = '\0';
+    o->fd = fd;
+    o->kind = BIO_READ;
+    o->state = BIO_QUEUED;
+    o->failed = 0;
+    o->buf = buf;
+    o->len = len;
+    uring_queue(idx);
+#endif
+}
+
+void bio_submit(void) {
+#ifdef BIO_HAVE_URING
+    if (use_uring) {
+        uring_enter(0);
+        uring_reap();
+    }
+#endif
+}
+
+char *bio_take(const char *path, size_t *len) {
+    int idx = use_uring ? find_read(path) : -1;
+
+    if (idx < 0) {
+        // Not prefetched (or fallback mode): read it now
+        char *buf;
+        int fd = open_for_read(path, &buf, len);
+        if (fd < 0) return NULL;
+        int err = read_rest(fd, buf, *len, 0);
+        close(fd);
+        if (err) {
+            free(buf);
+            return NULL;
+        }
+        return buf;
+    }
+
+#ifdef BIO_HAVE_URING
+    while (ops[idx].state != BIO_DONE) {
+        uring_enter(1);
+        uring_reap();
+    }
+#endif
+    BioOp *o = &ops[idx];
+    char *buf = o->buf;
+    *len = o->len;
+    o->state = BIO_FREE;
+    if (o->failed) {
+        free(buf);
+        return NULL;
+    }
+    return buf;
+}
+
+void bio_write(const char *path, char *data, size_t len) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "ERROR: Cannot create '%s'\n", path);
+        write_errors++;
+        free(data);
+        return;
+    }
+
+    int idx = (use_uring && len > 0) ? alloc_op() : -1;
+    if (idx < 0) {
+        if (write_rest(fd, data, len, 0) < 0) {
+            fprintf(stderr, "ERROR: Cannot write '%s'\n", path);
+            write_errors++;
+        }
+        close(fd);
+        free(data);
+        return;
+    }
+
+#ifdef BIO_HAVE_URING
+    BioOp *o = &ops[idx];
+    strncpy(o->path, path, sizeof(o->path) - 1);
+    o->path[sizeof(o->path) - 1] = '\0';
+    o->fd = fd;
+    o->kind = BIO_WRITE;
+    o->state = BIO_QUEUED;
+    o->buf = data;
+    o->len = len;
+    uring_queue(idx);
+#endif
+}
+
+int bio_finish(void) {
+#ifdef BIO_HAVE_URING
+    if (use_uring) {
+        for (;;) {
+            int busy = 0;
+            for (int i = 0; i < BIO_MAX; i++)
+                if (ops[i].state == BIO_QUEUED) busy = 1;
+            if (!busy) break;
+            uring_enter(1);
+            uring_reap();
+        }
+    }
+#endif
+    // Prefetched inputs that were never taken
+    for (int i = 0; i < BIO_MAX; i++) {
+        if (ops[i].state == BIO_DONE) {
+            free(ops[i].buf);
+            ops[i].state = BIO_FREE;
+        }
+    }
+    return write_errors;
+}
+#endif
@@ -0,0 +1,3 @@
+0000  14
+0001  00
+0002  03
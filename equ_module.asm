@@ -0,0 +1,18 @@
+PROG EQUT
+START
+SIZE: EQU FIN-TABLE
+LIMIT: EQU SIZE+60
+LDA TABLE+2
+ADD #SIZE
+SUB #10-2
+ADD #2+SIZE
+STA LIMIT
+STA TABLE+SIZE
+BEQ FIN-1
+HLT
+TABLE: BYTE 1
+BYTE 2
+BYTE 3
+BYTE 4
+FIN: BYTE 0
+END
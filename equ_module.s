@@ -0,0 +1,13 @@
+0000  E1  00 00
+0003  A2  00
+0005  A4  08
+0007  A2  00
+0009  F1  00 00
+000C  F1  00 00
+000F  B1  00 00
+0012  FE
+0013  01
+0014  02
+0015  03
+0016  04
+0017  00
@@ -0,0 +1,5 @@
+DAT
+1
+D
+HDRM
+H EQUT 0 18
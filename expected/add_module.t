@@ -0,0 +1,7 @@
+DAT
+3
+HDRM
+H SBR1 0 6
+D AD5 0
+R YY
+M YY 3
@@ -0,0 +1,6 @@
+DAT
+HDRM
+H DT 0 3
+D XX 0
+D YY 1
+D ZZ 2
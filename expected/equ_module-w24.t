@@ -0,0 +1,5 @@
+DAT
+1
+15
+HDRM
+H EQUT 0 22 W24
@@ -0,0 +1,16 @@
+DAT
+1
+4
+7
+A
+D
+10
+13
+1C
+1F
+22
+28
+HDRM
+H LITS 0 2C
+LINES literal_module.asm D
+D8015858585858589E015858585848
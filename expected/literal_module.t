@@ -0,0 +1,14 @@
+DAT
+1
+4
+7
+A
+D
+10
+13
+1C
+1F
+22
+28
+HDRM
+H LITS 0 2C
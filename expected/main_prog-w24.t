@@ -0,0 +1,17 @@
+DAT
+1
+5
+9
+D
+15
+21
+HDRM
+H MAIN 0 25 W24
+R AD5
+R XX
+R ZZ
+M XX 1
+M AD5 5
+M ZZ 9
+M AD5 D
+M ZZ 15
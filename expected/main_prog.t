@@ -0,0 +1,17 @@
+DAT
+1
+4
+7
+A
+10
+18
+HDRM
+H MAIN 0 1B
+R AD5
+R XX
+R ZZ
+M XX 1
+M AD5 4
+M ZZ 7
+M AD5 A
+M ZZ 10
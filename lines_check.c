@@ -0,0 +1,52 @@
+/**
+ * lines_check - make test driver for line_table_lookup()
+ *
+ * Reads the LINES section of literal_module.t (assembled with -g) and looks
+ * up addresses at the start of an instruction, inside one, in the literal
+ * pool between JMP NEXT and NEXT, in the pool after HLT and past the end of
+ * the module. Only addresses covered by an instruction have a source line.
+ */
+
+#include <stdio.h>
+#include "asm_common.h"
+
+static const struct { int address, line; } CASES[] = {
+    { 0x00,  3 },   // L0: LDA =100
+    { 0x02,  3 },   // last operand byte of LDA =100
+    { 0x14,  9 },   // inside JMP NEXT
+    { 0x15, -1 },   // POOL: first literal
+    { 0x1A, -1 },   // last literal of the LTORG pool
+    { 0x1B, 11 },   // NEXT: ADD =100
+    { 0x2A, 16 },   // HLT
+    { 0x2B, -1 },   // pool placed at END
+    { 0x100, -1 },  // past the end of the module
+    { -1,   -1 },   // before the module
+};
+
+int main(void) {
+    LineTable lt;
+    FILE *ftab = fopen("literal_module.t", "r");
+    if (!ftab) {
+        fprintf(stderr, "ERROR: Cannot open 'literal_module.t'\n");
+        return 1;
+    }
+    int rc = tab_read_lines(ftab, &lt);
+    fclose(ftab);
+    if (rc < 0) {
+        fprintf(stderr, "ERROR: No LINES section in literal_module.t\n");
+        line_table_free(&lt);
+        return 1;
+    }
+
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+        int line = line_table_lookup(&lt, CASES[i].address);
+        if (line != CASES[i].line) {
+            printf("lines_check: %X -> %d, expected %d\n", CASES[i].address, line, CASES[i].line);
+            ok = 0;
+        }
+    }
+    printf("lines_check: %d lines from %s %s\n", lt.count, lt.file, ok ? "ok" : "FAILED");
+    line_table_free(&lt);
+    return ok ? 0 : 1;
+}
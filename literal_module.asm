@@ -0,0 +1,17 @@
+PROG LITS
+START
+L0: LDA =100
+L1: ADD =101
+L2: ADD =102
+L3: SUB =103
+L4: ADD =104
+L5: ADD =-1
+JMP NEXT
+POOL: LTORG
+NEXT: ADD =100
+ADD =255
+ADD =7
+STA 90
+LDA POOL
+HLT
+END
@@ -0,0 +1,20 @@
+0000  E1  00 00
+0003  A1  00 00
+0006  A1  00 00
+0009  A3  00 00
+000C  A1  00 00
+000F  A1  00 00
+0012  B4  00 00
+0015  64
+0016  65
+0017  66
+0018  67
+0019  68
+001A  FF
+001B  A1  00 15
+001E  A1  00 1A
+0021  A1  00 00
+0024  F1  00 5A
+0027  E1  00 15
+002A  FE
+002B  07
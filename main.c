@@ -1,47 +1,154 @@
+#define _POSIX_C_SOURCE 200809L
 #include "asm_common.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
-int main(int argc, char *argv[]) {
-    char input_file[256] = "input.asm";  // Default input file
+// Modules whose source reads are in flight together in batch mode
+#define BATCH_GROUP 8
+
+// Derives <base>.s/.o/.t from the input name (".asm" is dropped)
+static void make_output_names(const char *input_file, char *s_file, char *o_file, char *t_file) {
     char base_name[256];
-    char s_file[260], o_file[260], t_file[260];
-    
-    // Get input file from command line argument if provided
-    if (argc > 1) {
-        strncpy(input_file, argv[1], 255);
-        input_file[255] = '\0';
-    }
-    
-    // Create base name by removing .asm extension
     strncpy(base_name, input_file, 255);
     base_name[255] = '\0';
     char *dot = strrchr(base_name, '.');
     if (dot && strcmp(dot, ".asm") == 0) {
         *dot = '\0';
     }
-    
+    snprintf(s_file, 260, "%s.s", base_name);
+    snprintf(o_file, 260, "%s.o", base_name);
+    snprintf(t_file, 260, "%s.t", base_name);
+}
+
+#ifdef ASM_HAVE_POSIX
+/**
+ * Batch mode (several input files): sources for the next group are read
+ * while the current group is assembled, and the .s/.o/.t outputs are built
+ * in memory and queued as writes (batchio.c). Pass 2 reads the .s text from
+ * memory instead of reopening the file.
+ */
+static int assemble_batch(char **inputs, int n) {
+    int failed = 0;
+    int uring = bio_init();
+
+    printf("SMPL Assembler\n");
+    printf("==============\n");
+    printf("Batch: %d modules, %s I/O\n\n", n, uring ? "io_uring" : "read/write");
+
+    for (int i = 0; i < n && i < BATCH_GROUP; i++) bio_prefetch(inputs[i]);
+    bio_submit();
+
+    for (int i = 0; i < n; i++) {
+        if (i % BATCH_GROUP == 0) {
+            // Start reading the next group before assembling this one
+            for (int j = i + BATCH_GROUP; j < n && j < i + 2 * BATCH_GROUP; j++)
+                bio_prefetch(inputs[j]);
+            bio_submit();
+        }
+
+        char s_file[260], o_file[260], t_file[260];
+        make_output_names(inputs[i], s_file, o_file, t_file);
+        strncpy(source_file, inputs[i], sizeof(source_file) - 1);
+
+        size_t src_len;
+        char *src = bio_take(inputs[i], &src_len);
+        if (!src) {
+            fprintf(stderr, "ERROR: Cannot open input file '%s'\n", inputs[i]);
+            failed++;
+            continue;
+        }
+
+        char *s_buf = NULL, *o_buf = NULL, *t_buf = NULL;
+        size_t s_len = 0, o_len = 0, t_len = 0;
+
+        // fmemopen needs a non-empty buffer; src and s_buf are NUL-terminated
+        FILE *in = fmemopen(src, src_len + 1, "r");
+        FILE *sout = open_memstream(&s_buf, &s_len);
+        if (!in || !sout) {
+            // Stop here, but still flush the writes queued for earlier modules
+            fprintf(stderr, "ERROR: Cannot open memory streams for '%s'\n", inputs[i]);
+            if (in) fclose(in);
+            if (sout) fclose(sout);
+            free(s_buf);
+            free(src);
+            failed++;
+            break;
+        }
+
+        ParsedLine pl;
+        reset_parser();
+        init_pass1();
+        while (get_next_parsed_line(in, &pl)) {
+            process_parsed_line_pass1(&pl, sout);
+        }
+        finalize_pass1(sout);
+        fclose(sout);
+        fclose(in);
+        free(src);
+
+        FILE *sin = fmemopen(s_buf, s_len + 1, "r");
+        FILE *fobj = open_memstream(&o_buf, &o_len);
+        FILE *ftab = open_memstream(&t_buf, &t_len);
+        if (!sin || !fobj || !ftab) {
+            fprintf(stderr, "ERROR: Cannot open memory streams for '%s'\n", inputs[i]);
+            if (sin) fclose(sin);
+            if (fobj) fclose(fobj);
+            if (ftab) fclose(ftab);
+            free(s_buf);
+            free(o_buf);
+            free(t_buf);
+            failed++;
+            break;
+        }
+        run_pass2(sin, fobj, ftab);
+        fclose(sin);
+        fclose(fobj);
+        fclose(ftab);
+
+        bio_write(s_file, s_buf, s_len);
+        bio_write(o_file, o_buf, o_len);
+        bio_write(t_file, t_buf, t_len);
+
+        printf("%s -> %s, %s, %s\n", inputs[i], s_file, o_file, t_file);
+    }
+
+    failed += bio_finish();
+    printf("\nAssembly complete.\n");
+    return failed ? 1 : 0;
+}
+#endif
+
+// Assembles one module through the .s file (or the .o file with -s)
+static int assemble_file(const char *input_file) {
+    char s_file[260], o_file[260], t_file[260];
+
     // Create output filenames
-    snprintf(s_file, sizeof(s_file), "%s.s", base_name);
-    snprintf(o_file, sizeof(o_file), "%s.o", base_name);
-    snprintf(t_file, sizeof(t_file), "%s.t", base_name);
+    make_output_names(input_file, s_file, o_file, t_file);
+    strncpy(source_file, input_file, sizeof(source_file) - 1);
     
     printf("SMPL Assembler\n");
     printf("==============\n");
     printf("Input file: %s\n", input_file);
     
+    // Streaming mode: Pass 1 output goes straight to the .o file
     FILE *in = fopen(input_file, "r");
-    FILE *sout = fopen(s_file, "w");
+    FILE *sout = fopen(stream_mode ? o_file : s_file, "w");
 
     if (!in) {
         fprintf(stderr, "ERROR: Cannot open input file '%s'\n", input_file);
         return 1;
     }
     if (!sout) {
-        fprintf(stderr, "ERROR: Cannot create intermediate file '%s'\n", s_file);
+        fprintf(stderr, "ERROR: Cannot create intermediate file '%s'\n", stream_mode ? o_file : s_file);
         fclose(in);
         return 1;
     }
+    if (stream_mode && stream_begin(sout) < 0) {
+        fclose(in);
+        fclose(sout);
+        return 1;
+    }
 
     ParsedLine pl;
 
@@ -62,7 +169,7 @@ int main(int argc, char *argv[]) {
     printf("\nSymbol Table (ST):\n");
     for (int i = 0; i < 10; i++) {
         if (ST[i].symbol[0] != '\0') {
-            printf("  %s = %04X\n", ST[i].symbol, ST[i].address);
+            printf("  %s = %0*X\n", ST[i].symbol, addr_bytes * 2, ST[i].address);
         }
     }
     
@@ -71,11 +178,40 @@ int main(int argc, char *argv[]) {
     int frt_count = 0;
     for (int i = 0; i < 20; i++) {
         if (FRT[i].symbol[0] != '\0') {
-            printf("  %s at %04X\n", FRT[i].symbol, FRT[i].address);
+            printf("  %s at %0*X\n", FRT[i].symbol, addr_bytes * 2, FRT[i].address);
             frt_count++;
         }
     }
     if (frt_count == 0) printf("  (empty)\n");
+
+    // Display Literal Table (only when the module uses =value operands)
+    if (LITT[0].symbol[0] != '\0') {
+        printf("\nLiteral Table (LITT):\n");
+        for (int i = 0; i < 20 && LITT[i].symbol[0] != '\0'; i++) {
+            printf("  %s at %0*X\n", LITT[i].symbol, addr_bytes * 2, LITT[i].address);
+        }
+    }
+
+    if (stream_mode) {
+        // Apply the fix-ups in place; Pass 2 only writes the tables
+        int rc = stream_finish();
+        fclose(sout);
+        fclose(in);
+
+        FILE *ftab = fopen(t_file, "w");
+        if (!ftab) {
+            fprintf(stderr, "ERROR: Cannot open files for Pass 2\n");
+            return 1;
+        }
+        printf("\n--- PASS 2 ---\n");
+        run_pass2(NULL, NULL, ftab);
+        fclose(ftab);
+
+        printf("Object file: %s\n", o_file);
+        printf("Table file: %s\n", t_file);
+        printf("\nAssembly complete.\n");
+        return rc < 0 ? 1 : 0;
+    }
     
     // Close .s output to flush
     fclose(sout);
@@ -107,3 +243,58 @@ int main(int argc, char *argv[]) {
 
     return 0;
 }
+
+int main(int argc, char *argv[]) {
+    char input_file[256] = "input.asm";  // Default input file
+    char **inputs = malloc(sizeof(char *) * argc);
+    int ninputs = 0;
+    
+    // Options: -c        compact DAT/M encoding in the .t file
+    //          -g        LC-to-source-line table in the .t file
+    //          -w24/-w32 24/32-bit address model (default 16-bit)
+    //          -s        streaming: write .o in Pass 1, patch with pwrite
+    //          -m N      streaming with at most N fix-ups in memory
+    // Non-option arguments are input files; more than one selects batch mode
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            compact_tab = 1;
+        } else if (strcmp(argv[i], "-g") == 0) {
+            emit_lines = 1;
+        } else if (strcmp(argv[i], "-w24") == 0) {
+            addr_bytes = 3;
+        } else if (strcmp(argv[i], "-w32") == 0) {
+            addr_bytes = 4;
+        } else if (strcmp(argv[i], "-s") == 0) {
+            stream_mode = 1;
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            stream_mode = 1;
+            stream_budget = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Usage: %s [-c] [-g] [-w24|-w32] [-s] [-m N] [input.asm ...]\n", argv[0]);
+            return 1;
+        } else {
+            inputs[ninputs++] = argv[i];
+            strncpy(input_file, argv[i], 255);
+            input_file[255] = '\0';
+        }
+    }
+
+    if (ninputs > 1) {
+#ifdef ASM_HAVE_POSIX
+        if (stream_mode) {
+            fprintf(stderr, "WARNING: -s/-m ignored in batch mode\n");
+            stream_mode = 0;
+        }
+        int rc = assemble_batch(inputs, ninputs);
+#else
+        // No memory streams without POSIX: assemble the modules one by one
+        int rc = 0;
+        for (int i = 0; i < ninputs; i++) rc |= assemble_file(inputs[i]);
+#endif
+        free(inputs);
+        return rc;
+    }
+    free(inputs);
+
+    return assemble_file(input_file);
+}
@@ -0,0 +1,10 @@
+0000  E1  00 00
+0003  C1  00 00
+0006  A1  00 00
+0009  C1  00 00
+000C  F1  00 46
+000F  E1  00 00
+0012  A4  01
+0014  B3  00 00
+0017  B4  00 00
+001A  FE
@@ -0,0 +1,13 @@
+DATB 1 18
+498280
+HDRM
+H MAIN 0 1B
+R AD5
+R XX
+R ZZ
+MV AD5 2
+0406
+MV XX 1
+01
+MV ZZ 2
+0709
@@ -30,7 +30,9 @@ static int is_pseudo(const char *op) {
            (strcmp(op, "WORD")   == 0) ||
            (strcmp(op, "PROG")   == 0) ||
            (strcmp(op, "ENTRY")  == 0) ||
-           (strcmp(op, "EXTREF") == 0);
+           (strcmp(op, "EXTREF") == 0) ||
+           (strcmp(op, "EQU")    == 0) ||
+           (strcmp(op, "LTORG")  == 0);
 }
 
 static int is_branch(const char *op) {
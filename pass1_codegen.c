@@ -10,10 +10,18 @@ int prog_len = 0;
 
 int LC = 0;
 
+// Address model: 2 = 16-bit (default), 3 = 24-bit, 4 = 32-bit (-w24 / -w32)
+int addr_bytes = 2;
+
 struct SymbolTable     ST[10];
 struct ForwardRefTable FRT[20];
 struct DirectAdrTable  DAT[30];
 struct HDRMTable       HDRMT[20];
+struct ExprTable       EXPT[20];
+struct LineNumTable    LNT[500];
+struct LiteralTable    LITT[20];
+int lnt_count = 0;
+int lnt_overflow = 0;   // LNT ran out: the module gets no LINES section
 struct Memory          M[500];
 
 // Opcode Table from Project Spec
@@ -62,11 +70,27 @@ const char* get_opcode_hex(const char* mnemonic, AddrMode mode) {
     return e->opcode_str;
 }
 
+// Immediates are 1 byte in the 16-bit model and address-sized in wide models
+int imm_bytes(void) {
+    return (addr_bytes == 2) ? 1 : addr_bytes;
+}
+
 int get_instr_size(const char* mnemonic, AddrMode mode) {
-    if (mode == AM_IMMEDIATE) return 2;
+    if (mode == AM_IMMEDIATE) return 1 + imm_bytes();
     if (mode == AM_IMPLIED) return 1;
-    // Direct or Relative -> 3
-    return 3;
+    // Direct or Relative -> opcode + address
+    return 1 + addr_bytes;
+}
+
+// Writes one .s/.o line: "LC  OP  B1 B2 ..." with big-endian operand bytes.
+// Data lines (BYTE/WORD) pass op = NULL: "LC  B1 B2".
+void write_code_line(FILE *f, int lc, const char *op, int value, int nbytes) {
+    fprintf(f, "%0*X", addr_bytes * 2, lc);
+    if (op) fprintf(f, "  %s", op);
+    for (int i = nbytes - 1; i >= 0; i--) {
+        fprintf(f, (i == nbytes - 1) ? "  %02X" : " %02X", (value >> (8 * i)) & 0xFF);
+    }
+    fprintf(f, "\n");
 }
 
 // --- Tables Helpers ---
@@ -104,6 +128,7 @@ int find_symbol_address(const char *label) {
 }
 
 int insert_frt(const char *symbol, int address) {
+    if (stream_mode) return stream_add_fixup(symbol, -1, address, addr_bytes);
     for (int i = 0; i < 20; i++) {
         if (FRT[i].symbol[0] == '\0') {
             strcpy(FRT[i].symbol, symbol);
@@ -148,6 +173,210 @@ int insert_dat(int address) {
     return -1;
 }
 
+int insert_line(int address, int line, int size) {
+    if (lnt_count == 500) {
+        // Reported once; a truncated table would map addresses wrongly
+        if (!lnt_overflow)
+            fprintf(stderr, "WARNING: Line table full at line %d, no LINES section for %s\n",
+                    line, module_name);
+        lnt_overflow = 1;
+        return -1;
+    }
+    LNT[lnt_count].address = address;
+    LNT[lnt_count].line = line;
+    LNT[lnt_count].size = size;
+    lnt_count++;
+    return 0;
+}
+
+// Adds a literal to the pool unless the same value is already there
+// (pending or placed); returns its LITT index
+int insert_literal(const char *symbol, int value) {
+    for (int i = 0; i < 20; i++) {
+        if (strcmp(LITT[i].symbol, symbol) == 0) return i;
+    }
+    for (int i = 0; i < 20; i++) {
+        if (LITT[i].symbol[0] == '\0') {
+            strcpy(LITT[i].symbol, symbol);
+            LITT[i].value = value;
+            LITT[i].placed = 0;
+            return i;
+        }
+    }
+    fprintf(stderr, "ERROR: Literal table full\n");
+    return -1;
+}
+
+// Pool address of a placed literal, -1 if it is unknown or still pending
+int find_literal_address(const char *symbol) {
+    for (int i = 0; i < 20; i++) {
+        if (LITT[i].placed && strcmp(LITT[i].symbol, symbol) == 0)
+            return LITT[i].address;
+    }
+    return -1;
+}
+
+// Places the pending literals at LC (LTORG / END), one BYTE per value
+void flush_literals(FILE *sout) {
+    for (int i = 0; i < 20; i++) {
+        if (LITT[i].symbol[0] == '\0' || LITT[i].placed) continue;
+        LITT[i].address = LC;
+        LITT[i].placed = 1;
+        write_code_line(sout, LC, NULL, LITT[i].value, 1);
+        LC += 1;
+    }
+}
+
+void remove_dat(int address) {
+    for (int i = 0; i < 30; i++) {
+        if (DAT[i].address == address) DAT[i].address = -1;
+    }
+}
+
+// --- Expressions ---
+
+int find_equ(const char *symbol) {
+    for (int i = 0; i < 20; i++) {
+        if (EXPT[i].symbol[0] != '\0' && strcmp(EXPT[i].symbol, symbol) == 0)
+            return i;
+    }
+    return -1;
+}
+
+int is_absolute_equ(const char *symbol) {
+    int e = find_equ(symbol);
+    return e >= 0 && EXPT[e].state == EXPR_DONE && EXPT[e].reloc == 0;
+}
+
+int insert_expr(const char *symbol, const char *expr, int address, int nbytes, int dat_site) {
+    for (int i = 0; i < 20; i++) {
+        if (EXPT[i].expr[0] == '\0') {
+            strcpy(EXPT[i].symbol, symbol);
+            strcpy(EXPT[i].expr, expr);
+            EXPT[i].address = address;
+            EXPT[i].nbytes = nbytes;
+            EXPT[i].dat_site = dat_site;
+            EXPT[i].immediate = 0;
+            EXPT[i].state = EXPR_PENDING;
+            if (stream_mode && symbol[0] == '\0'
+                    && stream_add_fixup("", i, address, nbytes) < 0) return -1;
+            return i;
+        }
+    }
+    fprintf(stderr, "ERROR: Expression table full\n");
+    return -1;
+}
+
+int is_expression(const char *operand) {
+    // A sign after the first character: TABLE+4, END-START
+    return operand[0] != '\0' && strpbrk(operand + 1, "+-") != NULL;
+}
+
+static int resolve_node(int i);
+
+// Value of one term: decimal number, EQU symbol or label
+static int eval_term(const char *term, int *value, int *reloc, int final) {
+    if (isdigit((unsigned char)term[0])) {
+        *value = atoi(term);
+        *reloc = 0;
+        return EXPR_DONE;
+    }
+
+    int e = find_equ(term);
+    if (e >= 0) {
+        if (EXPT[e].state == EXPR_PENDING && final) resolve_node(e);
+        if (EXPT[e].state == EXPR_VISITING) {
+            fprintf(stderr, "ERROR: Circular EQU definition of %s\n", term);
+            return EXPR_ERROR;
+        }
+        if (EXPT[e].state == EXPR_DONE) {
+            *value = EXPT[e].value;
+            *reloc = EXPT[e].reloc;
+        }
+        return EXPT[e].state;
+    }
+
+    int addr = find_symbol_address(term);
+    if (addr >= 0) {
+        *value = addr;
+        *reloc = 1;
+        return EXPR_DONE;
+    }
+    if (is_external(term)) {
+        fprintf(stderr, "ERROR: External symbol %s in expression\n", term);
+        return EXPR_ERROR;
+    }
+    if (final) {
+        fprintf(stderr, "ERROR: Undefined symbol %s in expression\n", term);
+        return EXPR_ERROR;
+    }
+    return EXPR_PENDING;
+}
+
+// Evaluates "term {+|- term}". With final = 0 (during Pass 1) an undefined
+// symbol yields EXPR_PENDING; with final = 1 pending EQUs are resolved first.
+int eval_expr(const char *expr, int *value, int *reloc, int final) {
+    int total = 0, rel = 0, sign = 1;
+    int result = EXPR_DONE;
+    const char *p = expr;
+
+    // Leading sign: -1+K
+    if (*p == '+' || *p == '-') sign = (*p++ == '-') ? -1 : 1;
+
+    while (*p) {
+        char term[32];
+        int n = 0;
+        while (*p && *p != '+' && *p != '-' && n < 31) {
+            if (!isspace((unsigned char)*p)) term[n++] = *p;
+            p++;
+        }
+        term[n] = '\0';
+
+        if (n == 0) {
+            fprintf(stderr, "ERROR: Malformed expression %s\n", expr);
+            return EXPR_ERROR;
+        }
+
+        int v = 0, r = 0;
+        int st = eval_term(term, &v, &r, final);
+        if (st == EXPR_ERROR) return EXPR_ERROR;
+        if (st != EXPR_DONE) result = EXPR_PENDING;
+
+        total += sign * v;
+        rel += sign * r;
+
+        if (*p == '+') sign = 1;
+        else if (*p == '-') sign = -1;
+        if (*p) p++;
+    }
+
+    if (result != EXPR_DONE) return result;
+
+    if (rel != 0 && rel != 1) {
+        fprintf(stderr, "ERROR: Expression %s is not relocatable\n", expr);
+        return EXPR_ERROR;
+    }
+    *value = total;
+    *reloc = rel;
+    return EXPR_DONE;
+}
+
+// Depth-first evaluation: every node is evaluated once, after its operands
+static int resolve_node(int i) {
+    if (EXPT[i].state != EXPR_PENDING) return EXPT[i].state;
+
+    EXPT[i].state = EXPR_VISITING;
+    int value = 0, reloc = 0;
+    int st = eval_expr(EXPT[i].expr, &value, &reloc, 1);
+    EXPT[i].state = (st == EXPR_DONE) ? EXPR_DONE : EXPR_ERROR;
+    EXPT[i].value = value;
+    EXPT[i].reloc = reloc;
+
+    if (EXPT[i].state == EXPR_DONE && EXPT[i].symbol[0] != '\0')
+        insert_symbol(EXPT[i].symbol, value);
+    return EXPT[i].state;
+}
+
 void init_pass1(void) {
     LC = 0;
     prog_start = 0;
@@ -156,6 +385,10 @@ void init_pass1(void) {
     memset(ST, 0, sizeof(ST));
     memset(FRT, 0, sizeof(FRT));
     memset(HDRMT, 0, sizeof(HDRMT));
+    memset(EXPT, 0, sizeof(EXPT));
+    memset(LITT, 0, sizeof(LITT));
+    lnt_count = 0;
+    lnt_overflow = 0;
     memset(M, 0, sizeof(M));
     for(int i=0; i<30; i++) DAT[i].address = -1;
 }
@@ -168,6 +401,15 @@ int parse_immediate_value(const char *operand) {
     return 0;
 }
 
+// Bare decimal number with an optional sign ("5", "-1"); anything else
+// is evaluated as an expression
+int is_signed_number(const char *s) {
+    if (*s == '+' || *s == '-') s++;
+    if (!isdigit((unsigned char)*s)) return 0;
+    while (isdigit((unsigned char)*s)) s++;
+    return *s == '\0';
+}
+
 int parse_word_value(const char *op) {
     return atoi(op);
 }
@@ -201,9 +443,16 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
              return;
         }
         if (strcmp(pl->opcode, "END") == 0) {
+             flush_literals(sout);
              prog_len = LC - prog_start;
              return;
         }
+        if (strcmp(pl->opcode, "LTORG") == 0) {
+             // A label names the start of the pool
+             if (pl->label[0] != '\0') insert_symbol(pl->label, LC);
+             flush_literals(sout);
+             return;
+        }
         if (strcmp(pl->opcode, "ENTRY") == 0) {
             char temp[32];
             strncpy(temp, pl->operand, 31);
@@ -215,6 +464,24 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
             }
             return;
         }
+        if (strcmp(pl->opcode, "EQU") == 0) {
+            if (pl->label[0] == '\0' || pl->operand[0] == '\0') {
+                fprintf(stderr, "ERROR: EQU needs a label and a value at line %d\n", pl->line_no);
+                return;
+            }
+            int e = insert_expr(pl->label, pl->operand, -1, 0, -1);
+            if (e < 0) return;
+
+            // Evaluate now if all operands are known, else leave it pending
+            int value = 0, reloc = 0;
+            int st = eval_expr(pl->operand, &value, &reloc, 0);
+            if (st == EXPR_PENDING) return;
+            EXPT[e].state = st;
+            EXPT[e].value = value;
+            EXPT[e].reloc = reloc;
+            if (st == EXPR_DONE) insert_symbol(pl->label, value);
+            return;
+        }
         if (strcmp(pl->opcode, "EXTREF") == 0) {
             char temp[32];
             strncpy(temp, pl->operand, 31);
@@ -234,7 +501,7 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
 
     if (strcmp(pl->opcode, "WORD") == 0) {
         int value = parse_word_value(pl->operand);
-        fprintf(sout, "%04X  %02X %02X\n", LC, (value >> 8) & 0xFF, value & 0xFF);
+        write_code_line(sout, LC, NULL, value, 2);
         LC += 2;
         return;
     }
@@ -244,7 +511,7 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
              const char *p = pl->operand + 2;
              int addr = LC;
              while (*p && *p != '\'') {
-                 fprintf(sout, "%04X  %02X\n", addr, (unsigned char)*p);
+                 write_code_line(sout, addr, NULL, (unsigned char)*p, 1);
                  addr++; p++;
              }
              LC = addr;
@@ -255,14 +522,14 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
              int addr = LC;
              while (*p && *p != '\'') {
                  int byte = parse_hex_byte(p);
-                 fprintf(sout, "%04X  %02X\n", addr, byte);
+                 write_code_line(sout, addr, NULL, byte, 1);
                  addr++; p+=2;
              }
              LC = addr;
              return;
         }
         int val = atoi(pl->operand);
-        fprintf(sout, "%04X  %02X\n", LC, val & 0xFF);
+        write_code_line(sout, LC, NULL, val, 1);
         LC += 1;
         return;
     }
@@ -278,16 +545,38 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
     int oldLC = LC;
     LC += instr_size;
 
+    if (emit_lines) insert_line(oldLC, pl->line_no, instr_size);
+
     if (pl->addr_mode == AM_IMPLIED) {
-        fprintf(sout, "%04X  %s\n", oldLC, op_hex);
+        write_code_line(sout, oldLC, op_hex, 0, 0);
     }
     else if (pl->addr_mode == AM_IMMEDIATE) {
-        int val = parse_immediate_value(pl->operand);
-        if (instr_size == 2) {
-             fprintf(sout, "%04X  %s  %02X\n", oldLC, op_hex, val & 0xFF);
+        int val = 0;
+        const char *imm = pl->operand + 1;
+        if (is_signed_number(imm)) {
+            val = parse_immediate_value(pl->operand);
         } else {
-             fprintf(sout, "%04X  %s  %02X%02X\n", oldLC, op_hex, (val>>8)&0xFF, val&0xFF);
+            // #SYMBOL or #expression (#10-2, #2+K): value from EQU/labels
+            int reloc = 0;
+            int st = eval_expr(imm, &val, &reloc, 0);
+            if (st == EXPR_DONE && reloc) {
+                // An address moves with the load base, the immediate would not
+                fprintf(stderr, "ERROR: Immediate %s is relocatable at line %d\n",
+                        pl->operand, pl->line_no);
+                val = 0;
+            } else if (st != EXPR_DONE) {
+                if (st == EXPR_PENDING) {
+                    int e = insert_expr("", imm, oldLC, imm_bytes(), -1);
+                    if (e >= 0) EXPT[e].immediate = 1;
+                }
+                val = 0;
+            }
         }
+        if (addr_bytes == 2 && (val > 255 || val < -128)) {
+            fprintf(stderr, "WARNING: Immediate %d truncated to 8 bits at line %d\n",
+                    val, pl->line_no);
+        }
+        write_code_line(sout, oldLC, op_hex, val, imm_bytes());
     }
     else if (pl->addr_mode == AM_DIRECT || pl->addr_mode == AM_RELATIVE) {
         // Check if operand is a numeric literal address (e.g., STA 70)
@@ -299,7 +588,55 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
             }
         }
 
-        if (is_numeric && pl->operand[0] != '\0') {
+        if (pl->operand[0] == '=') {
+            // Literal: constant in the module's literal pool. Direct loads read
+            // one byte (M[a]), so a pool entry is one BYTE.
+            int value = atoi(pl->operand + 1);
+            char name[10];
+
+            if (!is_signed_number(pl->operand + 1)) {
+                fprintf(stderr, "ERROR: Literal %s is not a decimal number at line %d\n",
+                        pl->operand, pl->line_no);
+                write_code_line(sout, oldLC, op_hex, 0, addr_bytes);
+                return;
+            }
+            if (value > 255 || value < -128) {
+                fprintf(stderr, "ERROR: Literal %d does not fit in a byte at line %d\n",
+                        value, pl->line_no);
+                write_code_line(sout, oldLC, op_hex, 0, addr_bytes);
+                return;
+            }
+            value &= 0xFF;
+            snprintf(name, sizeof(name), "=%d", value);
+
+            if (pl->addr_mode == AM_RELATIVE) {
+                fprintf(stderr, "ERROR: Literal operand for branch at line %d\n", pl->line_no);
+            } else {
+                insert_dat(oldLC + 1);
+            }
+
+            int lit = insert_literal(name, value);
+            if (lit >= 0 && LITT[lit].placed) {
+                // Already placed by an earlier LTORG: reuse it
+                write_code_line(sout, oldLC, op_hex, LITT[lit].address, addr_bytes);
+            } else {
+                // Patched from LITT by Pass 2 once the pool is placed
+                if (lit >= 0) insert_frt(name, oldLC);
+                write_code_line(sout, oldLC, op_hex, 0, addr_bytes);
+            }
+        } else if (is_expression(pl->operand)) {
+            int dat_site = (pl->addr_mode == AM_DIRECT) ? oldLC + 1 : -1;
+            int value = 0, reloc = 0;
+            int st = eval_expr(pl->operand, &value, &reloc, 0);
+            if (st == EXPR_DONE) {
+                if (reloc && dat_site >= 0) insert_dat(dat_site);
+            } else {
+                // Patched by Pass 2 once finalize_pass1 has evaluated it
+                if (st == EXPR_PENDING) insert_expr("", pl->operand, oldLC, addr_bytes, dat_site);
+                value = 0;
+            }
+            write_code_line(sout, oldLC, op_hex, value, addr_bytes);
+        } else if (is_numeric && pl->operand[0] != '\0') {
             // Pure numeric address - use directly
             int num_addr = atoi(pl->operand);
             if (pl->addr_mode == AM_DIRECT) {
@@ -307,10 +644,10 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
                 // But per spec example "STA 70" -> "F1 00 70", address 70 is absolute
                 // We DON'T add numeric literals to DAT (they're absolute, not relocatable)
             }
-            fprintf(sout, "%04X  %s  %02X %02X\n", oldLC, op_hex, (num_addr >> 8) & 0xFF, num_addr & 0xFF);
+            write_code_line(sout, oldLC, op_hex, num_addr, addr_bytes);
         } else {
-            // Symbol operand
-            if (pl->addr_mode == AM_DIRECT) {
+            // Symbol operand (absolute EQU constants are not relocated)
+            if (pl->addr_mode == AM_DIRECT && !is_absolute_equ(pl->operand)) {
                 insert_dat(oldLC + 1);
             }
 
@@ -320,15 +657,15 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
                 // Symbol found - use absolute address
                 // Note: Per project spec, both direct and relative use absolute addresses in object code
                 // The "relative" mode just means branch instructions, but the output still shows target address
-                fprintf(sout, "%04X  %s  %02X %02X\n", oldLC, op_hex, (addr >> 8) & 0xFF, addr & 0xFF);
+                write_code_line(sout, oldLC, op_hex, addr, addr_bytes);
             } else {
                 if (is_external(pl->operand)) {
                     insert_hdrm('M', pl->operand, oldLC + 1);
-                    fprintf(sout, "%04X  %s  00 00\n", oldLC, op_hex);
+                    write_code_line(sout, oldLC, op_hex, 0, addr_bytes);
                 } else {
                     // Forward reference - add to FRT for Pass 2 resolution
                     insert_frt(pl->operand, oldLC); 
-                    fprintf(sout, "%04X  %s  00 00\n", oldLC, op_hex);
+                    write_code_line(sout, oldLC, op_hex, 0, addr_bytes);
                 }
             }
         }
@@ -336,6 +673,35 @@ void process_parsed_line_pass1(const ParsedLine *pl, FILE *sout) {
 }
 
 void finalize_pass1(FILE *sout) {
+    if (addr_bytes < 4 && prog_start + prog_len > (1 << (8 * addr_bytes))) {
+        fprintf(stderr, "ERROR: Program does not fit in %d-bit addresses, use -w%d\n",
+                8 * addr_bytes, 8 * addr_bytes + 8);
+    }
+
+    // Evaluate pending EQUs and expression sites in dependency order
+    for (int i = 0; i < 20; i++) {
+        if (EXPT[i].expr[0] != '\0') resolve_node(i);
+    }
+    for (int i = 0; i < 20; i++) {
+        if (EXPT[i].state == EXPR_DONE && EXPT[i].reloc && EXPT[i].immediate) {
+            // Left as 0 by Pass 2, as for an immediate known in Pass 1
+            fprintf(stderr, "ERROR: Immediate #%s is relocatable at %X\n",
+                    EXPT[i].expr, EXPT[i].address);
+            EXPT[i].state = EXPR_ERROR;
+        }
+        if (EXPT[i].state == EXPR_DONE && EXPT[i].reloc && EXPT[i].dat_site >= 0)
+            insert_dat(EXPT[i].dat_site);
+        if (EXPT[i].state == EXPR_DONE && EXPT[i].nbytes == 1
+                && (EXPT[i].value > 255 || EXPT[i].value < -128))
+            fprintf(stderr, "WARNING: Immediate %s = %d truncated to 8 bits at %X\n",
+                    EXPT[i].expr, EXPT[i].value, EXPT[i].address);
+    }
+    // Forward references to absolute EQUs got a DAT entry before the EQU was known
+    for (int i = 0; i < 20; i++) {
+        if (FRT[i].symbol[0] != '\0' && is_absolute_equ(FRT[i].symbol))
+            remove_dat(FRT[i].address + 1);
+    }
+
     for (int i = 0; i < 20; i++) {
         if (HDRMT[i].code == 'D') {
             int addr = find_symbol_address(HDRMT[i].symbol);
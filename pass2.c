@@ -2,6 +2,13 @@
 #include <string.h>
 #include <stdlib.h>
 
+// Set by main (-c): write DAT and M records in compact form
+int compact_tab = 0;
+
+// Set by main (-g): append a LINES section mapping LCs to source lines
+int emit_lines = 0;
+char source_file[64];
+
 /**
  * Pass 2 - Forward Reference Resolution (İleri Referans Çözümleme)
  * 
@@ -25,10 +32,20 @@ void run_pass2(FILE *sin, FILE *fobj, FILE *ftab) {
     // DAT tablosu, relocatable adreslerin listesidir.
     // Pass 1'de direct addressing kullanan instruction'ların operand adresleri buraya eklenmiştir.
     // Bu tablo linker tarafından relocation işlemi için kullanılacak.
-    fprintf(ftab, "DAT\n");
-    for (int i = 0; i < 30; i++) {
-        if (DAT[i].address != -1) {
-            fprintf(ftab, "%X\n", DAT[i].address);
+    if (compact_tab) {
+        // Sıkıştırılmış format: sıralı delta varint'ler ya da bitmap (tabfile.c)
+        int addrs[30];
+        int n = 0;
+        for (int i = 0; i < 30; i++) {
+            if (DAT[i].address != -1) addrs[n++] = DAT[i].address;
+        }
+        write_dat_compact(ftab, addrs, n);
+    } else {
+        fprintf(ftab, "DAT\n");
+        for (int i = 0; i < 30; i++) {
+            if (DAT[i].address != -1) {
+                fprintf(ftab, "%X\n", DAT[i].address);
+            }
         }
     }
 
@@ -43,7 +60,12 @@ void run_pass2(FILE *sin, FILE *fobj, FILE *ftab) {
     fprintf(ftab, "HDRM\n");
     
     // H (Header) kaydı: Modül bilgileri
-    fprintf(ftab, "H %s %X %X\n", module_name, prog_start, prog_len);
+    // Geniş adres modunda (-w24/-w32) adres genişliği H kaydına eklenir: "H MAIN 0 1B W24"
+    if (addr_bytes == 2) {
+        fprintf(ftab, "H %s %X %X\n", module_name, prog_start, prog_len);
+    } else {
+        fprintf(ftab, "H %s %X %X W%d\n", module_name, prog_start, prog_len, 8 * addr_bytes);
+    }
     
     // D, R, M kayıtlarını yaz
     for (int i = 0; i < 20; i++) {
@@ -53,15 +75,45 @@ void run_pass2(FILE *sin, FILE *fobj, FILE *ftab) {
         } else if (HDRMT[i].code == 'R') {
             // R (Reference): Bu modülde kullanılan ama başka modülde tanımlı semboller
             fprintf(ftab, "R %s\n", HDRMT[i].symbol);
-        } else if (HDRMT[i].code == 'M') {
+        } else if (HDRMT[i].code == 'M' && !compact_tab) {
             // M (Modify): External sembolün kullanıldığı adres (linker bu adresi patch edecek)
             fprintf(ftab, "M %s %X\n", HDRMT[i].symbol, HDRMT[i].address);
         }
     }
 
+    if (compact_tab) {
+        // M kayıtları sembol başına gruplanır: isim bir kez, adresler delta olarak
+        for (int i = 0; i < 20; i++) {
+            if (HDRMT[i].code != 'R') continue;
+            int addrs[20];
+            int n = 0;
+            for (int j = 0; j < 20; j++) {
+                if (HDRMT[j].code == 'M' && strcmp(HDRMT[j].symbol, HDRMT[i].symbol) == 0)
+                    addrs[n++] = HDRMT[j].address;
+            }
+            if (n > 0) write_mrec_compact(ftab, HDRMT[i].symbol, addrs, n);
+        }
+    }
+
+    // LINES bölümü: her instruction'ın LC'si ve kaynak satırı (delta kodlu)
+    // LNT taştıysa (lnt_overflow) eksik tablo yazılmaz
+    if (emit_lines && !lnt_overflow) {
+        int addrs[500], lines[500], sizes[500];
+        for (int i = 0; i < lnt_count; i++) {
+            addrs[i] = LNT[i].address;
+            lines[i] = LNT[i].line;
+            sizes[i] = LNT[i].size;
+        }
+        write_line_table(ftab, source_file, addrs, lines, sizes, lnt_count);
+    }
+
     // ============================================================
     // ADIM 3: .s Dosyasını İşleyerek .o Dosyasını Oluştur
     // ============================================================
+    // Streaming modunda (-s) .o dosyası Pass 1'de yazıldı ve fix-up'lar
+    // stream_finish() ile yerinde (pwrite) uygulandı; sadece tablolar yazılır
+    if (sin == NULL) return;
+
     // .s dosyasını başa sar (rewind) çünkü tabloları yazdıktan sonra tekrar okumamız gerekiyor
     rewind(sin);
     
@@ -101,6 +153,27 @@ void run_pass2(FILE *sin, FILE *fobj, FILE *ftab) {
             }
         }
 
+        // ============================================================
+        // ADIM 3.2.1: Expression Table (EXPT) Kontrolü
+        // ============================================================
+        // TABLE+4 / #SIZE gibi ifadeler finalize_pass1'de hesaplandı;
+        // bu satır bir ifade patch noktasıysa değeri doğrudan yazılır
+        int expr_idx = -1;
+        for (int i = 0; i < 20; i++) {
+            if (EXPT[i].expr[0] != '\0' && EXPT[i].symbol[0] == '\0'
+                    && EXPT[i].address == line_lc) {
+                expr_idx = i;
+                break;
+            }
+        }
+
+        if (!patched && expr_idx >= 0 && EXPT[expr_idx].state == EXPR_DONE) {
+            char opcode[10];
+            sscanf(line, "%*x %s", opcode);
+            write_code_line(fobj, line_lc, opcode, EXPT[expr_idx].value, EXPT[expr_idx].nbytes);
+            continue;
+        }
+
         // ============================================================
         // ADIM 3.3: Satırı İşle
         // ============================================================
@@ -116,8 +189,9 @@ void run_pass2(FILE *sin, FILE *fobj, FILE *ftab) {
             // ============================================================
             // Pass 1'de sembol tanımlandığında ST'ye eklenmişti
             // Şimdi bu sembolün adresini ST'den buluyoruz
-            int addr = -1;
-            for (int i = 0; i < 10; i++) {
+            // "=value" literal sembolleri ST'de değil, LITT'de (literal pool) tutulur
+            int addr = (patch_symbol[0] == '=') ? find_literal_address(patch_symbol) : -1;
+            for (int i = 0; i < 10 && addr == -1; i++) {
                 if (strcmp(ST[i].symbol, patch_symbol) == 0) {
                     addr = ST[i].address;
                     break;
@@ -148,11 +222,9 @@ void run_pass2(FILE *sin, FILE *fobj, FILE *ftab) {
                 sscanf(line, "%*x %s", opcode);
                 
                 // Yeni satırı oluştur ve .o dosyasına yaz
-                // Adres 16-bit olduğu için 2 byte'a bölünür:
-                // - Yüksek byte: (addr >> 8) & 0xFF
-                // - Düşük byte:  addr & 0xFF
-                fprintf(fobj, "%04X  %s  %02X %02X\n", 
-                        line_lc, opcode, (addr >> 8) & 0xFF, addr & 0xFF);
+                // Adres addr_bytes byte'a bölünür (varsayılan 16-bit: 2 byte),
+                // yüksek byte önce gelir
+                write_code_line(fobj, line_lc, opcode, addr, addr_bytes);
             }
         }
     }
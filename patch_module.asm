@@ -0,0 +1,7 @@
+PROG PATCH
+START
+LDA #7
+STA P+1
+P: LDA #0
+HLT
+END
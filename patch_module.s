@@ -0,0 +1,4 @@
+0000  E2  07
+0002  F1  00 00
+0005  E2  00
+0007  FE
@@ -0,0 +1,6 @@
+DAT
+3
+HDRM
+H PATCH 0 8
+LINES patch_module.asm 4
+D001585048
@@ -0,0 +1,127 @@
+/* Generated by smpl2c from patch_module.o / patch_module.t -- do not edit */
+
+#define AW 2   /* address bytes */
+#define IW 1   /* immediate bytes */
+
+#include <stdint.h>
+
+#ifndef SMPL_MEM_SIZE
+#define SMPL_MEM_SIZE 65536L
+#endif
+
+#ifndef SMPL_STATE_DEFINED
+#define SMPL_STATE_DEFINED
+typedef struct {
+    uint8_t mem[SMPL_MEM_SIZE];
+    int     ac;
+    int     halted;
+    int     fault;     /* address of an undecodable opcode, or -1 */
+    int     code_dirty; /* set once a store has hit code: compiled code is stale */
+    uint8_t code[SMPL_MEM_SIZE / 8 + 1]; /* code bytes of every loaded module */
+} SmplState;
+#endif
+
+#define MEM(a) st->mem[(unsigned)(a) % SMPL_MEM_SIZE]
+#define CODE_BIT(a) ((unsigned)(a) % SMPL_MEM_SIZE)
+#define CODE(a) ((st->code[CODE_BIT(a) >> 3] >> (CODE_BIT(a) & 7)) & 1)
+#define CODE_SET(a) (st->code[CODE_BIT(a) >> 3] |= (uint8_t)(1 << (CODE_BIT(a) & 7)))
+
+static int smpl_read(SmplState *st, int at, int n) {
+    int v = 0;
+    for (int i = 0; i < n; i++) v = (v << 8) | MEM(at + i);
+    return v;
+}
+
+/* Immediates and memory bytes are signed: sign-extend n bytes */
+static inline int smpl_sext(int v, int n) {
+    int shift = 8 * (int)(sizeof(int) - n);
+    return (int)((unsigned)v << shift) >> shift;
+}
+
+static inline void smpl_write(SmplState *st, int at, int v, int n) {
+    for (int i = n - 1; i >= 0; i--, v >>= 8) MEM(at + i) = (uint8_t)v;
+}
+
+/* Fallback interpreter over st->mem (used after self-modifying stores) */
+static void smpl_interp(SmplState *st, int pc) {
+    for (;;) {
+        int op = MEM(pc);
+        int a = smpl_read(st, pc + 1, AW);
+        int imm = smpl_sext(smpl_read(st, pc + 1, IW), IW);
+        switch (op) {
+        case 0xA1: st->ac += (int8_t)MEM(a); pc += 1 + AW; break;
+        case 0xA2: st->ac += imm;    pc += 1 + IW; break;
+        case 0xA3: st->ac -= (int8_t)MEM(a); pc += 1 + AW; break;
+        case 0xA4: st->ac -= imm;    pc += 1 + IW; break;
+        case 0xB1: pc = (st->ac == 0) ? a : pc + 1 + AW; break;
+        case 0xB2: pc = (st->ac > 0)  ? a : pc + 1 + AW; break;
+        case 0xB3: pc = (st->ac < 0)  ? a : pc + 1 + AW; break;
+        case 0xB4: pc = a; break;
+        case 0xC1: smpl_interp(st, a); if (st->halted) return; pc += 1 + AW; break;
+        case 0xC2: return;
+        case 0xD1: st->ac--; pc += 1; break;
+        case 0xD2: st->ac++; pc += 1; break;
+        case 0xE1: st->ac = (int8_t)MEM(a); pc += 1 + AW; break;
+        case 0xE2: st->ac = imm;    pc += 1 + IW; break;
+        case 0xF1: MEM(a) = (uint8_t)st->ac; if (CODE(a)) st->code_dirty = 1;
+                   pc += 1 + AW; break;
+        case 0xFE: st->halted = 1; return;
+        default:   st->halted = 1; st->fault = pc; return;
+        }
+    }
+}
+
+#ifndef SMPL_PATCH_BASE
+#define SMPL_PATCH_BASE 0
+#endif
+#undef BASE
+#define BASE SMPL_PATCH_BASE
+
+#if SMPL_PATCH_BASE + 8 > SMPL_MEM_SIZE
+#error "SMPL_MEM_SIZE is too small for module PATCH at SMPL_PATCH_BASE"
+#endif
+
+
+static const uint8_t smpl_PATCH_image[8] = {
+    0xE2, 0x07, 0xF1, 0x00, 0x06, 0xE2, 0x00, 0xFE,
+};
+
+static const uint8_t smpl_PATCH_code_map[2] = {
+    0xFF,
+};
+
+void smpl_PATCH_load(SmplState *st) {
+    for (int i = 0; i < 8; i++) MEM(BASE + i) = smpl_PATCH_image[i];
+    for (int i = 0; i < 8; i++)
+        if ((smpl_PATCH_code_map[i >> 3] >> (i & 7)) & 1) CODE_SET(BASE + i);
+    smpl_write(st, BASE + 3, BASE + 0x0006, AW);
+}
+
+void smpl_PATCH(SmplState *st, int entry) {
+    if (st->code_dirty) { smpl_interp(st, BASE + entry); return; }
+    switch (entry) {
+    case 0x0000: goto L_0000;
+    default: smpl_interp(st, BASE + entry); return;
+    }
+
+L_0000:
+#line 3 "patch_module.asm"
+    /* 0000 LDA */ st->ac = 7;
+#line 4 "patch_module.asm"
+    /* 0002 STA */ MEM((BASE + 0x0006)) = (uint8_t)st->ac;
+    { st->code_dirty = 1; smpl_interp(st, BASE + 0x0005); return; }
+#line 5 "patch_module.asm"
+    /* 0005 LDA */ st->ac = 0;
+#line 6 "patch_module.asm"
+    /* 0007 HLT */ st->halted = 1; return;
+}
+
+#line 120 "patch_module_smpl.c"
+
+#undef BASE
+#undef MEM
+#undef CODE_BIT
+#undef CODE
+#undef CODE_SET
+#undef AW
+#undef IW
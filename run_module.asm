@@ -0,0 +1,10 @@
+PROG RUN
+START
+LDA #-1
+BLT NEG
+HLT
+NEG: ADD M3
+SUB #-2
+HLT
+M3: BYTE -3
+END
@@ -0,0 +1,7 @@
+0000  E2  FF
+0002  B3  00 00
+0005  FE
+0006  A1  00 00
+0009  A4  FE
+000B  FE
+000C  FD
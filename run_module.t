@@ -0,0 +1,4 @@
+DAT
+7
+HDRM
+H RUN 0 D
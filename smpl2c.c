@@ -0,0 +1,581 @@
+#include "asm_common.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+/**
+ * smpl2c - Static translator from assembled SMPL modules to C
+ *
+ * Reads <base>.o (object code) and <base>.t (DAT/HDRM tables) and writes
+ * one C function per module:
+ *
+ *   void smpl_<MOD>(SmplState *st, int entry);   run from a module address
+ *   void smpl_<MOD>_load(SmplState *st);         copy + relocate the image
+ *
+ * Instructions are decoded by following control flow from the module start,
+ * the D (ENTRY) symbols and CLL targets, so data bytes are never translated.
+ * Branches become gotos, CLL/RET become C calls/returns and memory is the
+ * byte array st->mem. The module is placed at SMPL_<MOD>_BASE (default 0);
+ * DAT sites are relocated against it, and M sites use smpl_addr_<SYM>,
+ * which the defining module exports for each D record.
+ *
+ * If the .t file has a line table (assembled with -g), every instruction is
+ * preceded by a #line directive pointing at its .asm source line.
+ *
+ * Every smpl_<MOD>_load() marks the module's code bytes in st->code, a
+ * bitmap shared by all loaded modules. A store that hits a marked byte sets
+ * st->code_dirty, leaves the compiled code and continues in smpl_interp(), a
+ * plain interpreter over st->mem. Once the flag is set, compiled callers
+ * resume interpreted after CLL returns and module functions start in the
+ * interpreter, so self-modifying modules still run correctly.
+ */
+
+// Byte offsets relative to prog_start
+#define F_CODE   0x01   // byte belongs to a decoded instruction
+#define F_INSN   0x02   // first byte of a decoded instruction
+#define F_LABEL  0x04   // branch target, needs a C label
+#define F_ENTRY  0x08   // reachable through smpl_<MOD>(st, entry)
+#define F_RELOC  0x10   // DAT site
+#define F_EXT    0x20   // M site, index in ext_of[]
+
+typedef enum { K_DIRECT, K_IMMEDIATE, K_IMPLIED } OpKind;
+
+// Decoding table, mirrors OPTAB plus the immediate forms
+static const struct {
+    int    code;
+    char   mnemonic[4];
+    OpKind kind;
+} DECODE[] = {
+    {0xA1, "ADD", K_DIRECT},  {0xA2, "ADD", K_IMMEDIATE},
+    {0xA3, "SUB", K_DIRECT},  {0xA4, "SUB", K_IMMEDIATE},
+    {0xB1, "BEQ", K_DIRECT},  {0xB2, "BGT", K_DIRECT},
+    {0xB3, "BLT", K_DIRECT},  {0xB4, "JMP", K_DIRECT},
+    {0xC1, "CLL", K_DIRECT},  {0xC2, "RET", K_IMPLIED},
+    {0xD1, "DEC", K_IMPLIED}, {0xD2, "INC", K_IMPLIED},
+    {0xE1, "LDA", K_DIRECT},  {0xE2, "LDA", K_IMMEDIATE},
+    {0xF1, "STA", K_DIRECT},  {0xFE, "HLT", K_IMPLIED}
+};
+static const int DECODE_SIZE = sizeof(DECODE) / sizeof(DECODE[0]);
+
+static char mod_name[10];
+static int  mod_start = 0;
+static int  mod_len = 0;
+static int  aw = 2;     // address bytes (H record "W24"/"W32" widens it)
+static int  iw = 1;     // immediate bytes
+
+static unsigned char *image;   // code image, mod_len bytes
+static unsigned char *flags;   // F_* per byte
+static int           *ext_of;  // M site -> index into ext_syms
+
+static char ext_syms[64][10];
+static int  ext_count = 0;
+
+static struct { char symbol[10]; int address; } defs[64];
+static int def_count = 0;
+
+static LineTable lines;        // from the LINES section (-g), may be empty
+
+static int decode_index(int code) {
+    for (int i = 0; i < DECODE_SIZE; i++)
+        if (DECODE[i].code == code) return i;
+    return -1;
+}
+
+static int insn_size(OpKind k) {
+    if (k == K_DIRECT) return 1 + aw;
+    if (k == K_IMMEDIATE) return 1 + iw;
+    return 1;
+}
+
+static int in_module(int addr) {
+    return addr >= mod_start && addr < mod_start + mod_len;
+}
+
+// Big-endian n-byte value at image offset
+static int read_be(int off, int n) {
+    int v = 0;
+    for (int i = 0; i < n; i++) v = (v << 8) | image[off + i];
+    return v;
+}
+
+static int operand_at(int off) {
+    return read_be(off + 1, aw);
+}
+
+// Immediates are signed (#-1 is FF): sign-extend from iw bytes
+static int immediate_at(int off) {
+    int shift = 8 * (int)(sizeof(int) - iw);
+    return (int)((unsigned)read_be(off + 1, iw) << shift) >> shift;
+}
+
+static int ext_index(const char *symbol) {
+    for (int i = 0; i < ext_count; i++)
+        if (strcmp(ext_syms[i], symbol) == 0) return i;
+    if (ext_count == 64) {
+        fprintf(stderr, "ERROR: Too many external symbols\n");
+        exit(1);
+    }
+    strcpy(ext_syms[ext_count], symbol);
+    return ext_count++;
+}
+
+// Identifiers in the generated C: keep [A-Za-z0-9_]
+static void c_ident(char *dst, const char *src) {
+    int i = 0;
+    for (; src[i] && i < 9; i++)
+        dst[i] = isalnum((unsigned char)src[i]) ? src[i] : '_';
+    dst[i] = '\0';
+}
+
+// --- Input ---
+
+static void on_tab_record(char code, const char *symbol, int address, int value, void *ctx) {
+    switch (code) {
+    case 'H':
+        strncpy(mod_name, symbol, 9);
+        mod_start = address;
+        mod_len = value;
+        break;
+    case 'W':
+        aw = address / 8;
+        iw = (aw == 2) ? 1 : aw;
+        break;
+    case 'D':
+        if (def_count < 64) {
+            strcpy(defs[def_count].symbol, symbol);
+            defs[def_count].address = address;
+            def_count++;
+        }
+        break;
+    case 'R':
+        // Declared in R order, which the plain and compact (-c) .t share
+        ext_index(symbol);
+        break;
+    }
+}
+
+static void on_tab_reloc(char code, const char *symbol, int address, int value, void *ctx) {
+    int off = address - mod_start;
+    if (off < 0 || off >= mod_len) return;
+    if (code == 'A') {
+        flags[off] |= F_RELOC;
+    } else if (code == 'M') {
+        flags[off] |= F_EXT;
+        ext_of[off] = ext_index(symbol);
+    }
+}
+
+static int load_object(FILE *fobj) {
+    char line[256];
+    while (fgets(line, sizeof(line), fobj)) {
+        int lc;
+        int n = 0;
+        if (sscanf(line, "%x%n", &lc, &n) != 1) continue;
+
+        // Remaining tokens are hex bytes ("E1  00 1A", "E2  05", "00 05")
+        const char *p = line + n;
+        int addr = lc;
+        while (*p) {
+            while (*p && isspace((unsigned char)*p)) p++;
+            while (isxdigit((unsigned char)p[0]) && isxdigit((unsigned char)p[1])) {
+                char hex[3] = { p[0], p[1], '\0' };
+                if (in_module(addr)) image[addr - mod_start] = (unsigned char)strtol(hex, NULL, 16);
+                addr++;
+                p += 2;
+            }
+            while (*p && !isspace((unsigned char)*p)) p++;
+        }
+    }
+    return 0;
+}
+
+// --- Control flow ---
+
+static void decode_from(int off, int *work, int *nwork) {
+    int first = 1;
+    while (off >= 0 && off < mod_len && !(flags[off] & F_INSN)) {
+        int di = decode_index(image[off]);
+        if (di < 0) {
+            // D records may name data (ENTRY XX: BYTE 20); only warn mid-run
+            if (!first)
+                fprintf(stderr, "WARNING: Undecodable byte %02X at %04X\n", image[off], mod_start + off);
+            return;
+        }
+        first = 0;
+        int size = insn_size(DECODE[di].kind);
+        if (off + size > mod_len) return;
+
+        flags[off] |= F_INSN;
+        for (int i = 0; i < size; i++) flags[off + i] |= F_CODE;
+
+        int code = DECODE[di].code;
+
+        // BEQ/BGT/BLT hold a module address but get no DAT entry from Pass 1;
+        // treat an in-module target as relocatable so BASE applies to it too
+        if (code >= 0xB1 && code <= 0xB3 && !(flags[off + 1] & F_EXT) && in_module(operand_at(off)))
+            flags[off + 1] |= F_RELOC;
+
+        if (DECODE[di].kind == K_DIRECT && (code & 0xF0) != 0xA0 && code != 0xE1 && code != 0xF1
+                && (flags[off + 1] & F_RELOC)) {
+            // Branch / JMP / CLL with a relocatable, module-internal target
+            int t = operand_at(off) - mod_start;
+            if (t >= 0 && t < mod_len) {
+                flags[t] |= (code == 0xC1) ? F_ENTRY : F_LABEL;
+                work[(*nwork)++] = t;
+            }
+        }
+
+        if (code == 0xB4 || code == 0xC2 || code == 0xFE) return;
+        off += size;
+    }
+}
+
+static void discover_code(void) {
+    int *work = malloc(sizeof(int) * (mod_len * 2 + def_count + 1));
+    int nwork = 0;
+
+    flags[0] |= F_ENTRY;
+    work[nwork++] = 0;
+    for (int i = 0; i < def_count; i++) {
+        int off = defs[i].address - mod_start;
+        if (off >= 0 && off < mod_len) {
+            flags[off] |= F_ENTRY;
+            work[nwork++] = off;
+        }
+    }
+
+    while (nwork > 0) {
+        int off = work[--nwork];
+        decode_from(off, work, &nwork);
+    }
+    free(work);
+}
+
+// --- Output ---
+
+// C expression for the 16-bit operand of the instruction at off
+static void operand_expr(char *out, size_t n, int off) {
+    if (flags[off + 1] & F_EXT) {
+        char id[10];
+        c_ident(id, ext_syms[ext_of[off + 1]]);
+        snprintf(out, n, "smpl_addr_%s", id);
+    } else if (flags[off + 1] & F_RELOC) {
+        snprintf(out, n, "(BASE + 0x%04X)", operand_at(off) - mod_start);
+    } else {
+        snprintf(out, n, "0x%04X", operand_at(off));
+    }
+}
+
+// Default st->mem size: the 64 KiB address space for 16-bit modules; wide
+// modules get their address space capped at 16 MiB, but at least the module
+static long default_mem_size(void) {
+    if (aw == 2) return 1L << 16;
+    long size = 1L << 24;
+    while (size < mod_len) size <<= 1;
+    return size;
+}
+
+static void emit_runtime(FILE *out) {
+    fprintf(out, "#define AW %d   /* address bytes */\n#define IW %d   /* immediate bytes */\n\n", aw, iw);
+    fprintf(out,
+        "#include <stdint.h>\n\n"
+        "#ifndef SMPL_MEM_SIZE\n"
+        "#define SMPL_MEM_SIZE %ldL\n"
+        "#endif\n\n", default_mem_size());
+    fprintf(out,
+        "#ifndef SMPL_STATE_DEFINED\n"
+        "#define SMPL_STATE_DEFINED\n"
+        "typedef struct {\n"
+        "    uint8_t mem[SMPL_MEM_SIZE];\n"
+        "    int     ac;\n"
+        "    int     halted;\n"
+        "    int     fault;     /* address of an undecodable opcode, or -1 */\n"
+        "    int     code_dirty; /* set once a store has hit code: compiled code is stale */\n"
+        "    uint8_t code[SMPL_MEM_SIZE / 8 + 1]; /* code bytes of every loaded module */\n"
+        "} SmplState;\n"
+        "#endif\n\n"
+        "#define MEM(a) st->mem[(unsigned)(a) %% SMPL_MEM_SIZE]\n"
+        "#define CODE_BIT(a) ((unsigned)(a) %% SMPL_MEM_SIZE)\n"
+        "#define CODE(a) ((st->code[CODE_BIT(a) >> 3] >> (CODE_BIT(a) & 7)) & 1)\n"
+        "#define CODE_SET(a) (st->code[CODE_BIT(a) >> 3] |= (uint8_t)(1 << (CODE_BIT(a) & 7)))\n\n"
+        "static int smpl_read(SmplState *st, int at, int n) {\n"
+        "    int v = 0;\n"
+        "    for (int i = 0; i < n; i++) v = (v << 8) | MEM(at + i);\n"
+        "    return v;\n"
+        "}\n\n"
+        "/* Immediates and memory bytes are signed: sign-extend n bytes */\n"
+        "static inline int smpl_sext(int v, int n) {\n"
+        "    int shift = 8 * (int)(sizeof(int) - n);\n"
+        "    return (int)((unsigned)v << shift) >> shift;\n"
+        "}\n\n"
+        "static inline void smpl_write(SmplState *st, int at, int v, int n) {\n"
+        "    for (int i = n - 1; i >= 0; i--, v >>= 8) MEM(at + i) = (uint8_t)v;\n"
+        "}\n\n"
+        "/* Fallback interpreter over st->mem (used after self-modifying stores) */\n"
+        "static void smpl_interp(SmplState *st, int pc) {\n"
+        "    for (;;) {\n"
+        "        int op = MEM(pc);\n"
+        "        int a = smpl_read(st, pc + 1, AW);\n"
+        "        int imm = smpl_sext(smpl_read(st, pc + 1, IW), IW);\n"
+        "        switch (op) {\n"
+        "        case 0xA1: st->ac += (int8_t)MEM(a); pc += 1 + AW; break;\n"
+        "        case 0xA2: st->ac += imm;    pc += 1 + IW; break;\n"
+        "        case 0xA3: st->ac -= (int8_t)MEM(a); pc += 1 + AW; break;\n"
+        "        case 0xA4: st->ac -= imm;    pc += 1 + IW; break;\n"
+        "        case 0xB1: pc = (st->ac == 0) ? a : pc + 1 + AW; break;\n"
+        "        case 0xB2: pc = (st->ac > 0)  ? a : pc + 1 + AW; break;\n"
+        "        case 0xB3: pc = (st->ac < 0)  ? a : pc + 1 + AW; break;\n"
+        "        case 0xB4: pc = a; break;\n"
+        "        case 0xC1: smpl_interp(st, a); if (st->halted) return; pc += 1 + AW; break;\n"
+        "        case 0xC2: return;\n"
+        "        case 0xD1: st->ac--; pc += 1; break;\n"
+        "        case 0xD2: st->ac++; pc += 1; break;\n"
+        "        case 0xE1: st->ac = (int8_t)MEM(a); pc += 1 + AW; break;\n"
+        "        case 0xE2: st->ac = imm;    pc += 1 + IW; break;\n"
+        "        case 0xF1: MEM(a) = (uint8_t)st->ac; if (CODE(a)) st->code_dirty = 1;\n"
+        "                   pc += 1 + AW; break;\n"
+        "        case 0xFE: st->halted = 1; return;\n"
+        "        default:   st->halted = 1; st->fault = pc; return;\n"
+        "        }\n"
+        "    }\n"
+        "}\n\n");
+}
+
+// Number of lines written so far to out (a regular file at path)
+static int lines_written(FILE *out, const char *path) {
+    int n = 0, c;
+    fflush(out);
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    while ((c = fgetc(f)) != EOF) n += (c == '\n');
+    fclose(f);
+    return n;
+}
+
+static void emit_module(FILE *out, const char *src, const char *c_file) {
+    char id[10];
+    c_ident(id, mod_name[0] ? mod_name : "MOD");
+
+    fprintf(out, "/* Generated by smpl2c from %s.o / %s.t -- do not edit */\n\n", src, src);
+    emit_runtime(out);
+
+    fprintf(out, "#ifndef SMPL_%s_BASE\n#define SMPL_%s_BASE 0\n#endif\n", id, id);
+    fprintf(out, "#undef BASE\n#define BASE SMPL_%s_BASE\n\n", id);
+    fprintf(out, "#if SMPL_%s_BASE + %d > SMPL_MEM_SIZE\n", id, mod_len);
+    fprintf(out, "#error \"SMPL_MEM_SIZE is too small for module %s at SMPL_%s_BASE\"\n#endif\n\n", id, id);
+
+    // External symbols and entry points
+    for (int i = 0; i < ext_count; i++) {
+        char e[10];
+        c_ident(e, ext_syms[i]);
+        fprintf(out, "extern const int smpl_addr_%s;\n", e);
+        fprintf(out, "void smpl_entry_%s(SmplState *st);\n", e);
+    }
+    for (int i = 0; i < def_count; i++) {
+        char d[10];
+        c_ident(d, defs[i].symbol);
+        fprintf(out, "const int smpl_addr_%s = BASE + 0x%04X;\n", d, defs[i].address - mod_start);
+    }
+    fprintf(out, "\n");
+
+    // Image and code map used by the loader and the store check
+    fprintf(out, "static const uint8_t smpl_%s_image[%d] = {", id, mod_len > 0 ? mod_len : 1);
+    for (int i = 0; i < mod_len; i++)
+        fprintf(out, "%s0x%02X,", (i % 12) ? " " : "\n    ", image[i]);
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "static const uint8_t smpl_%s_code_map[%d] = {", id, (mod_len + 7) / 8 + 1);
+    for (int b = 0; b < (mod_len + 7) / 8; b++) {
+        int byte = 0;
+        for (int k = 0; k < 8 && b * 8 + k < mod_len; k++)
+            if (flags[b * 8 + k] & F_CODE) byte |= 1 << k;
+        fprintf(out, "%s0x%02X,", (b % 12) ? " " : "\n    ", byte);
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "void smpl_%s_load(SmplState *st) {\n", id);
+    fprintf(out, "    for (int i = 0; i < %d; i++) MEM(BASE + i) = smpl_%s_image[i];\n", mod_len, id);
+    // Register the code bytes in the shared map checked by every store
+    fprintf(out, "    for (int i = 0; i < %d; i++)\n", mod_len);
+    fprintf(out, "        if ((smpl_%s_code_map[i >> 3] >> (i & 7)) & 1) CODE_SET(BASE + i);\n", id);
+    for (int off = 0; off + aw <= mod_len; off++) {
+        if (!(flags[off] & (F_RELOC | F_EXT))) continue;
+        char expr[64];
+        if (flags[off] & F_EXT) {
+            char e[10];
+            c_ident(e, ext_syms[ext_of[off]]);
+            snprintf(expr, sizeof(expr), "smpl_addr_%s", e);
+        } else {
+            snprintf(expr, sizeof(expr), "BASE + 0x%04X", read_be(off, aw) - mod_start);
+        }
+        fprintf(out, "    smpl_write(st, BASE + %d, %s, AW);\n", off, expr);
+    }
+    fprintf(out, "}\n\n");
+
+    // Module function
+    fprintf(out, "void smpl_%s(SmplState *st, int entry) {\n", id);
+    fprintf(out, "    if (st->code_dirty) { smpl_interp(st, BASE + entry); return; }\n");
+    fprintf(out, "    switch (entry) {\n");
+    for (int off = 0; off < mod_len; off++)
+        if ((flags[off] & F_ENTRY) && (flags[off] & F_INSN))
+            fprintf(out, "    case 0x%04X: goto L_%04X;\n", off, off);
+    fprintf(out, "    default: smpl_interp(st, BASE + entry); return;\n    }\n\n");
+
+    int mapped = 0;         // a #line points into the .asm source
+    for (int off = 0; off < mod_len; off++) {
+        if (!(flags[off] & F_INSN)) continue;
+
+        int di = decode_index(image[off]);
+        int code = DECODE[di].code;
+        int next = off + insn_size(DECODE[di].kind);
+        char a[64];
+        operand_expr(a, sizeof(a), off);
+        int internal = !(flags[off + 1] & F_EXT) && in_module(operand_at(off));
+        int target = operand_at(off) - mod_start;
+
+        if (flags[off] & (F_LABEL | F_ENTRY)) fprintf(out, "L_%04X:\n", off);
+        // Map the generated code back to the .asm source for debuggers/profilers
+        int src_line = line_table_lookup(&lines, mod_start + off);
+        if (src_line > 0) {
+            fprintf(out, "#line %d \"%s\"\n", src_line, lines.file);
+            mapped = 1;
+        }
+        fprintf(out, "    /* %04X %s */ ", mod_start + off, DECODE[di].mnemonic);
+
+        switch (code) {
+        case 0xA1: fprintf(out, "st->ac += (int8_t)MEM(%s);\n", a); break;
+        case 0xA2: fprintf(out, "st->ac += %d;\n", immediate_at(off)); break;
+        case 0xA3: fprintf(out, "st->ac -= (int8_t)MEM(%s);\n", a); break;
+        case 0xA4: fprintf(out, "st->ac -= %d;\n", immediate_at(off)); break;
+        case 0xE1: fprintf(out, "st->ac = (int8_t)MEM(%s);\n", a); break;
+        case 0xE2: fprintf(out, "st->ac = %d;\n", immediate_at(off)); break;
+        case 0xD1: fprintf(out, "st->ac--;\n"); break;
+        case 0xD2: fprintf(out, "st->ac++;\n"); break;
+        case 0xC2: fprintf(out, "return;\n"); break;
+        case 0xFE: fprintf(out, "st->halted = 1; return;\n"); break;
+        case 0xB1: case 0xB2: case 0xB3: case 0xB4: {
+            const char *cond = (code == 0xB1) ? "st->ac == 0" :
+                               (code == 0xB2) ? "st->ac > 0"  :
+                               (code == 0xB3) ? "st->ac < 0"  : NULL;
+            if (cond) fprintf(out, "if (%s) ", cond);
+            if (internal && (flags[off + 1] & F_RELOC) && (flags[target] & F_INSN))
+                fprintf(out, "goto L_%04X;\n", target);
+            else
+                fprintf(out, "{ smpl_interp(st, %s); return; }\n", a);
+            break;
+        }
+        case 0xC1:
+            if (flags[off + 1] & F_EXT) {
+                char e[10];
+                c_ident(e, ext_syms[ext_of[off + 1]]);
+                fprintf(out, "smpl_entry_%s(st);", e);
+            } else if (internal && (flags[off + 1] & F_RELOC) && (flags[target] & F_INSN)) {
+                fprintf(out, "smpl_%s(st, 0x%04X);", id, target);
+            } else {
+                fprintf(out, "smpl_interp(st, %s);", a);
+            }
+            // The callee may have patched this module: resume interpreted
+            fprintf(out, " if (st->halted) return;\n");
+            fprintf(out, "    if (st->code_dirty) { smpl_interp(st, BASE + 0x%04X); return; }\n", next);
+            break;
+        case 0xF1:
+            fprintf(out, "MEM(%s) = (uint8_t)st->ac;\n", a);
+            if (internal && (flags[off + 1] & F_RELOC)) {
+                // Target known statically: only fall back when it is code
+                if (flags[target] & F_CODE)
+                    fprintf(out, "    { st->code_dirty = 1; smpl_interp(st, BASE + 0x%04X); return; }\n", next);
+            } else {
+                fprintf(out, "    if (CODE(%s)) { st->code_dirty = 1; smpl_interp(st, BASE + 0x%04X); return; }\n",
+                        a, next);
+            }
+            break;
+        }
+
+        // Falling off a decoded run into data or another module: interpret
+        if (code != 0xB4 && code != 0xC2 && code != 0xFE && (next >= mod_len || !(flags[next] & F_INSN)))
+            fprintf(out, "    smpl_interp(st, BASE + 0x%04X); return;\n", next);
+    }
+    fprintf(out, "}\n\n");
+    // Back to the generated file for the rest (#line names the next line)
+    if (mapped) fprintf(out, "#line %d \"%s\"\n", lines_written(out, c_file) + 2, c_file);
+
+    // C entry points for CLL from other modules
+    for (int i = 0; i < def_count; i++) {
+        char d[10];
+        c_ident(d, defs[i].symbol);
+        fprintf(out, "void smpl_entry_%s(SmplState *st) { smpl_%s(st, 0x%04X); }\n",
+                d, id, defs[i].address - mod_start);
+    }
+    fprintf(out, "\n#undef BASE\n#undef MEM\n#undef CODE_BIT\n#undef CODE\n#undef CODE_SET\n#undef AW\n#undef IW\n");
+}
+
+int main(int argc, char *argv[]) {
+    char base_name[256] = "";
+    char o_file[260], t_file[260], c_file[264] = "";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            strncpy(c_file, argv[++i], 263);
+            c_file[263] = '\0';
+        } else if (argv[i][0] == '-' || base_name[0]) {
+            fprintf(stderr, "Usage: %s module[.o] [-o out.c]\n", argv[0]);
+            return 1;
+        } else {
+            strncpy(base_name, argv[i], 255);
+            base_name[255] = '\0';
+        }
+    }
+    if (!base_name[0]) {
+        fprintf(stderr, "Usage: %s module[.o] [-o out.c]\n", argv[0]);
+        return 1;
+    }
+
+    char *dot = strrchr(base_name, '.');
+    if (dot && (strcmp(dot, ".o") == 0 || strcmp(dot, ".t") == 0 || strcmp(dot, ".asm") == 0))
+        *dot = '\0';
+
+    snprintf(o_file, sizeof(o_file), "%s.o", base_name);
+    snprintf(t_file, sizeof(t_file), "%s.t", base_name);
+    if (!c_file[0]) snprintf(c_file, sizeof(c_file), "%s_smpl.c", base_name);
+
+    FILE *fobj = fopen(o_file, "r");
+    FILE *ftab = fopen(t_file, "r");
+    if (!fobj || !ftab) {
+        fprintf(stderr, "ERROR: Cannot open '%s' / '%s'\n", o_file, t_file);
+        return 1;
+    }
+
+    // Header and D records first, so the image can be sized
+    tab_sweep(ftab, on_tab_record, NULL);
+    image  = calloc(mod_len + 5, 1);
+    flags  = calloc(mod_len + 5, 1);
+    ext_of = calloc(mod_len + 5, sizeof(int));
+    if (!image || !flags || !ext_of) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        return 1;
+    }
+    rewind(ftab);
+    tab_sweep(ftab, on_tab_reloc, NULL);
+    rewind(ftab);
+    if (tab_read_lines(ftab, &lines) < 0) line_table_free(&lines);
+    load_object(fobj);
+    fclose(fobj);
+    fclose(ftab);
+
+    discover_code();
+
+    FILE *out = fopen(c_file, "w");
+    if (!out) {
+        fprintf(stderr, "ERROR: Cannot create '%s'\n", c_file);
+        return 1;
+    }
+    emit_module(out, base_name, c_file);
+    fclose(out);
+
+    printf("Translated %s (%d bytes) -> %s\n", mod_name, mod_len, c_file);
+    free(image);
+    free(flags);
+    free(ext_of);
+    line_table_free(&lines);
+    return 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * smpl_run - make test driver for smpl2c
+ *
+ * Runs main_prog, add_module and data_module translated to C and linked
+ * together. MAIN is compiled into this file, SBR1 and DT are placed at
+ * 0x100 and 0x200 (SMPL_<MOD>_BASE). ZZ is cleared before the run, so the
+ * loop ends after one pass with M[70] = YY = 20 + 5 + 0 + 5 = 30.
+ *
+ * run_module (RUN, at 0x300) checks signed values: LDA #-1 must take BLT,
+ * and -1 + (BYTE -3) - (#-2) leaves AC = -2.
+ *
+ * patch_module (PATCH, at 0x400) stores 7 into the immediate of its own
+ * LDA #0, so the compiled code must fall back to smpl_interp(): AC = 7 and
+ * code_dirty is set. MAIN and RUN never store into code and leave it clear.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "main_prog_smpl.c"
+
+extern const int smpl_addr_XX, smpl_addr_YY, smpl_addr_ZZ;
+void smpl_SBR1_load(SmplState *st);
+void smpl_DT_load(SmplState *st);
+void smpl_RUN_load(SmplState *st);
+void smpl_RUN(SmplState *st, int entry);
+void smpl_PATCH_load(SmplState *st);
+void smpl_PATCH(SmplState *st, int entry);
+
+int main(void) {
+    SmplState *st = calloc(1, sizeof(SmplState));
+    if (!st) return 1;
+    st->fault = -1;
+
+    smpl_MAIN_load(st);
+    smpl_SBR1_load(st);
+    smpl_DT_load(st);
+    st->mem[smpl_addr_ZZ] = 0;
+
+    smpl_MAIN(st, 0);
+
+    int ok = st->halted && st->fault == -1 && st->ac == -1
+          && st->mem[70] == 30 && st->mem[smpl_addr_YY] == 30;
+    printf("smpl_run: M[70]=%d YY=%d AC=%d %s\n", st->mem[70], st->mem[smpl_addr_YY], st->ac,
+           ok ? "ok" : "FAILED");
+
+    st->halted = 0;
+    smpl_RUN_load(st);
+    smpl_RUN(st, 0);
+    int run_ok = st->halted && st->fault == -1 && st->ac == -2 && !st->code_dirty;
+    printf("smpl_run: RUN AC=%d %s\n", st->ac, run_ok ? "ok" : "FAILED");
+    ok = ok && run_ok;
+
+    st->halted = 0;
+    smpl_PATCH_load(st);
+    smpl_PATCH(st, 0);
+    int patch_ok = st->halted && st->fault == -1 && st->ac == 7 && st->code_dirty;
+    printf("smpl_run: PATCH AC=%d code_dirty=%d %s\n", st->ac, st->code_dirty,
+           patch_ok ? "ok" : "FAILED");
+    ok = ok && patch_ok;
+    free(st);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,377 @@
+#define _POSIX_C_SOURCE 200809L
+#include "asm_common.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * smplar - Module archiver
+ *
+ * Packs assembled modules (<base>.o + <base>.t) into one archive file with
+ * a precomputed hash index from D (ENTRY) symbol names to members, so a
+ * linker can resolve R records with a few probes instead of scanning
+ * every .t file.
+ *
+ *   smplar c lib.sar mod...     create archive from mod.o / mod.t
+ *   smplar t lib.sar            list members
+ *   smplar x lib.sar member     extract member.o / member.t
+ *   smplar f lib.sar SYM        find the member that defines SYM
+ *   smplar r lib.sar mod        resolve the R records of mod.t
+ *
+ * Layout (all integers are 32-bit little endian):
+ *
+ *   header     magic "SMPLAR1\n", nmembers, nslots, dir_off, index_off
+ *   directory  nmembers x { name[16], o_off, o_len, t_off, t_len }
+ *   index      nslots   x { symbol[12], member }   (member = ~0 when empty)
+ *   data       member .o and .t contents
+ *
+ * nslots is a power of two, at least twice the number of D symbols, and
+ * collisions use linear probing. Reading only maps the archive (mmap).
+ */
+
+#define AR_MAGIC      "SMPLAR1\n"
+#define AR_HDR_SIZE   24
+#define AR_DIR_SIZE   32
+#define AR_SLOT_SIZE  16
+#define AR_EMPTY      0xFFFFFFFFu
+
+typedef struct {
+    char           name[16];
+    unsigned char *o_data, *t_data;
+    long           o_len, t_len;
+} ArMember;
+
+typedef struct {
+    const unsigned char *base;
+    size_t               size;
+    uint32_t             nmembers, nslots, dir_off, index_off;
+} Archive;
+
+static void put_u32(unsigned char *p, uint32_t v) {
+    p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = (v >> 24) & 0xFF;
+}
+
+static uint32_t get_u32(const unsigned char *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// FNV-1a
+static uint32_t sym_hash(const char *s) {
+    uint32_t h = 2166136261u;
+    while (*s) { h ^= (unsigned char)*s++; h *= 16777619u; }
+    return h;
+}
+
+static unsigned char *read_file(const char *path, long *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    *len = ftell(f);
+    rewind(f);
+    unsigned char *buf = malloc(*len > 0 ? *len : 1);
+    if (buf && fread(buf, 1, *len, f) != (size_t)*len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    return buf;
+}
+
+// --- Create ---
+
+typedef struct {
+    char     symbol[12];
+    uint32_t member;
+} ArSymbol;
+
+static ArSymbol *syms;
+static int       nsyms, syms_cap;
+static uint32_t  cur_member;
+
+static void collect_defs(char code, const char *symbol, int address, int value, void *ctx) {
+    if (code != 'D') return;
+    for (int i = 0; i < nsyms; i++) {
+        if (strcmp(syms[i].symbol, symbol) == 0) {
+            fprintf(stderr, "WARNING: %s already defined in member %u, ignored\n", symbol, syms[i].member);
+            return;
+        }
+    }
+    if (nsyms == syms_cap) {
+        syms_cap = syms_cap ? syms_cap * 2 : 64;
+        syms = realloc(syms, sizeof(ArSymbol) * syms_cap);
+    }
+    memset(&syms[nsyms], 0, sizeof(ArSymbol));
+    strncpy(syms[nsyms].symbol, symbol, 11);
+    syms[nsyms].member = cur_member;
+    nsyms++;
+}
+
+static int ar_create(const char *ar_path, char **mods, int nmods) {
+    ArMember *members = calloc(nmods, sizeof(ArMember));
+
+    for (int i = 0; i < nmods; i++) {
+        char base[256], path[264];
+        strncpy(base, mods[i], 255);
+        base[255] = '\0';
+        char *dot = strrchr(base, '.');
+        if (dot && (strcmp(dot, ".o") == 0 || strcmp(dot, ".t") == 0)) *dot = '\0';
+
+        const char *slash = strrchr(base, '/');
+        strncpy(members[i].name, slash ? slash + 1 : base, 15);
+
+        snprintf(path, sizeof(path), "%s.o", base);
+        members[i].o_data = read_file(path, &members[i].o_len);
+        snprintf(path, sizeof(path), "%s.t", base);
+        members[i].t_data = read_file(path, &members[i].t_len);
+        if (!members[i].o_data || !members[i].t_data) {
+            fprintf(stderr, "ERROR: Cannot read module '%s'\n", base);
+            return 1;
+        }
+
+        FILE *ftab = fopen(path, "r");
+        cur_member = (uint32_t)i;
+        tab_sweep(ftab, collect_defs, NULL);
+        fclose(ftab);
+    }
+
+    uint32_t nslots = 16;
+    while (nslots < (uint32_t)nsyms * 2) nslots *= 2;
+
+    uint32_t dir_off = AR_HDR_SIZE;
+    uint32_t index_off = dir_off + AR_DIR_SIZE * nmods;
+    uint32_t data_off = index_off + AR_SLOT_SIZE * nslots;
+
+    unsigned char *meta = calloc(data_off, 1);
+    memcpy(meta, AR_MAGIC, 8);
+    put_u32(meta + 8, nmods);
+    put_u32(meta + 12, nslots);
+    put_u32(meta + 16, dir_off);
+    put_u32(meta + 20, index_off);
+
+    uint32_t off = data_off;
+    for (int i = 0; i < nmods; i++) {
+        unsigned char *d = meta + dir_off + AR_DIR_SIZE * i;
+        memcpy(d, members[i].name, 16);
+        put_u32(d + 16, off);
+        put_u32(d + 20, members[i].o_len);
+        off += members[i].o_len;
+        put_u32(d + 24, off);
+        put_u32(d + 28, members[i].t_len);
+        off += members[i].t_len;
+    }
+
+    for (uint32_t s = 0; s < nslots; s++)
+        put_u32(meta + index_off + AR_SLOT_SIZE * s + 12, AR_EMPTY);
+    for (int i = 0; i < nsyms; i++) {
+        uint32_t s = sym_hash(syms[i].symbol) & (nslots - 1);
+        while (get_u32(meta + index_off + AR_SLOT_SIZE * s + 12) != AR_EMPTY)
+            s = (s + 1) & (nslots - 1);
+        unsigned char *slot = meta + index_off + AR_SLOT_SIZE * s;
+        memcpy(slot, syms[i].symbol, 12);
+        put_u32(slot + 12, syms[i].member);
+    }
+
+    FILE *far = fopen(ar_path, "wb");
+    if (!far) {
+        fprintf(stderr, "ERROR: Cannot create archive '%s'\n", ar_path);
+        return 1;
+    }
+    fwrite(meta, 1, data_off, far);
+    for (int i = 0; i < nmods; i++) {
+        fwrite(members[i].o_data, 1, members[i].o_len, far);
+        fwrite(members[i].t_data, 1, members[i].t_len, far);
+        free(members[i].o_data);
+        free(members[i].t_data);
+    }
+    fclose(far);
+
+    printf("Archive %s: %d members, %d symbols, %u index slots\n", ar_path, nmods, nsyms, nslots);
+    free(meta);
+    free(members);
+    free(syms);
+    return 0;
+}
+
+// --- Read ---
+
+static int ar_open(const char *path, Archive *ar) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat sb;
+    if (fstat(fd, &sb) < 0 || sb.st_size < AR_HDR_SIZE) {
+        close(fd);
+        return -1;
+    }
+    void *p = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+
+    ar->base = p;
+    ar->size = sb.st_size;
+    ar->nmembers  = get_u32(ar->base + 8);
+    ar->nslots    = get_u32(ar->base + 12);
+    ar->dir_off   = get_u32(ar->base + 16);
+    ar->index_off = get_u32(ar->base + 20);
+
+    // Every table and member range must lie inside the mapping
+    int ok = memcmp(ar->base, AR_MAGIC, 8) == 0
+          && ar->dir_off + (uint64_t)ar->nmembers * AR_DIR_SIZE <= ar->size
+          && ar->index_off + (uint64_t)ar->nslots * AR_SLOT_SIZE <= ar->size
+          && ar->nslots != 0 && (ar->nslots & (ar->nslots - 1)) == 0;
+    for (uint32_t i = 0; ok && i < ar->nmembers; i++) {
+        const unsigned char *d = ar->base + ar->dir_off + AR_DIR_SIZE * i;
+        ok = (uint64_t)get_u32(d + 16) + get_u32(d + 20) <= ar->size
+          && (uint64_t)get_u32(d + 24) + get_u32(d + 28) <= ar->size;
+    }
+    if (!ok) {
+        munmap(p, ar->size);
+        return -2;
+    }
+    return 0;
+}
+
+static void ar_close(Archive *ar) {
+    munmap((void *)ar->base, ar->size);
+}
+
+static const unsigned char *ar_dir(const Archive *ar, uint32_t i) {
+    return ar->base + ar->dir_off + AR_DIR_SIZE * i;
+}
+
+// Returns the member index defining symbol, -1 if undefined, -2 if the
+// index slot names a member that does not exist
+static long ar_find(const Archive *ar, const char *symbol) {
+    char key[12] = {0};
+    strncpy(key, symbol, 11);
+
+    uint32_t mask = ar->nslots - 1;
+    for (uint32_t s = sym_hash(key) & mask, n = 0; n < ar->nslots; s = (s + 1) & mask, n++) {
+        const unsigned char *slot = ar->base + ar->index_off + AR_SLOT_SIZE * s;
+        uint32_t member = get_u32(slot + 12);
+        if (member == AR_EMPTY) return -1;
+        if (member >= ar->nmembers) return -2;
+        if (memcmp(slot, key, 12) == 0) return member;
+    }
+    return -1;
+}
+
+static long ar_member_by_name(const Archive *ar, const char *name) {
+    for (uint32_t i = 0; i < ar->nmembers; i++)
+        if (strncmp((const char *)ar_dir(ar, i), name, 16) == 0) return i;
+    return -1;
+}
+
+// A member name used as an output path: NUL-terminated within its 16
+// bytes, non-empty, and without '/' or ".." so it stays in the directory
+static int safe_member_name(const unsigned char *d) {
+    const char *name = (const char *)d;
+    if (!memchr(d, '\0', 16) || name[0] == '\0') return 0;
+    return strchr(name, '/') == NULL && strstr(name, "..") == NULL;
+}
+
+static int write_range(const char *path, const Archive *ar, uint32_t off, uint32_t len) {
+    if ((uint64_t)off + len > ar->size) return -1;
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+    fwrite(ar->base + off, 1, len, f);
+    fclose(f);
+    return 0;
+}
+
+static void print_r(char code, const char *symbol, int address, int value, void *ctx) {
+    if (code != 'R') return;
+    const Archive *ar = ctx;
+    long m = ar_find(ar, symbol);
+    if (m == -2) printf("  %-9s (corrupt index)\n", symbol);
+    else if (m < 0) printf("  %-9s (undefined)\n", symbol);
+    else printf("  %-9s %.16s\n", symbol, (const char *)ar_dir(ar, m));
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3 || strlen(argv[1]) != 1) {
+        fprintf(stderr, "Usage: %s c|t|x|f|r archive [args...]\n", argv[0]);
+        return 1;
+    }
+
+    char cmd = argv[1][0];
+    if (cmd == 'c') return ar_create(argv[2], argv + 3, argc - 3);
+
+    Archive ar;
+    int err = ar_open(argv[2], &ar);
+    if (err < 0) {
+        fprintf(stderr, err == -2 ? "ERROR: Corrupt archive '%s'\n"
+                                  : "ERROR: Cannot open archive '%s'\n", argv[2]);
+        return 1;
+    }
+
+    int rc = 0;
+    switch (cmd) {
+    case 't':
+        for (uint32_t i = 0; i < ar.nmembers; i++) {
+            const unsigned char *d = ar_dir(&ar, i);
+            printf("%-16.16s  .o %u bytes  .t %u bytes\n", (const char *)d, get_u32(d + 20), get_u32(d + 28));
+        }
+        break;
+    case 'x':
+        for (int i = 3; i < argc; i++) {
+            long m = ar_member_by_name(&ar, argv[i]);
+            char path[32];
+            if (m < 0) {
+                fprintf(stderr, "ERROR: No member '%s'\n", argv[i]);
+                rc = 1;
+                continue;
+            }
+            const unsigned char *d = ar_dir(&ar, m);
+            if (!safe_member_name(d)) {
+                fprintf(stderr, "ERROR: Unsafe member name '%.16s'\n", (const char *)d);
+                rc = 1;
+                continue;
+            }
+            snprintf(path, sizeof(path), "%s.o", (const char *)d);
+            if (write_range(path, &ar, get_u32(d + 16), get_u32(d + 20)) < 0) rc = 1;
+            snprintf(path, sizeof(path), "%s.t", (const char *)d);
+            if (write_range(path, &ar, get_u32(d + 24), get_u32(d + 28)) < 0) rc = 1;
+        }
+        break;
+    case 'f':
+        for (int i = 3; i < argc; i++) {
+            long m = ar_find(&ar, argv[i]);
+            if (m == -2) {
+                fprintf(stderr, "ERROR: Corrupt archive index for %s\n", argv[i]);
+                rc = 1;
+            } else if (m < 0) {
+                printf("%s: undefined\n", argv[i]);
+                rc = 1;
+            } else {
+                printf("%s: %.16s\n", argv[i], (const char *)ar_dir(&ar, m));
+            }
+        }
+        break;
+    case 'r':
+        for (int i = 3; i < argc; i++) {
+            char path[264];
+            snprintf(path, sizeof(path), "%s.t", argv[i]);
+            FILE *ftab = fopen(path, "r");
+            if (!ftab) {
+                fprintf(stderr, "ERROR: Cannot open '%s'\n", path);
+                rc = 1;
+                continue;
+            }
+            printf("%s:\n", argv[i]);
+            tab_sweep(ftab, print_r, &ar);
+            fclose(ftab);
+        }
+        break;
+    default:
+        fprintf(stderr, "Usage: %s c|t|x|f|r archive [args...]\n", argv[0]);
+        rc = 1;
+    }
+
+    ar_close(&ar);
+    return rc;
+}
@@ -0,0 +1,258 @@
+#define _POSIX_C_SOURCE 200809L
+#include "asm_common.h"
+#include <string.h>
+#include <stdlib.h>
+#ifdef ASM_HAVE_POSIX
+#include <unistd.h>
+#endif
+
+/**
+ * Streaming assembly (-s)
+ *
+ * Pass 1 writes finished lines straight into the .o file instead of the .s
+ * file, so there is no intermediate file and no rewind-and-rewrite in Pass 2.
+ * Every operand that cannot be filled in yet (forward reference, literal or
+ * pending expression) is recorded as a fix-up holding the file offset of its
+ * operand bytes.
+ *
+ * Fix-ups are buffered in memory up to stream_budget entries (-m N). When
+ * the buffer is full it is sorted by offset and written to a spill file as
+ * one run. At the end, the runs and the in-memory rest are merged by offset
+ * and each fix-up is resolved from ST/EXPT and written in place with
+ * pwrite(), so memory use does not grow with the module size. The merge
+ * reads each run a block at a time, the blocks sharing the same budget. Without
+ * POSIX the .o stream itself is seeked and written instead.
+ */
+
+typedef struct {
+    long offset;      // file offset of the operand text in the .o file
+    int  lc;          // LC of the instruction
+    int  nbytes;      // operand bytes to write
+    int  expr_idx;    // EXPT index for expression sites, else -1
+    char symbol[10];
+} Fixup;
+
+typedef struct {
+    long start;       // first record in the spill file
+    long count;
+} SpillRun;
+
+// Merge cursor over one run: a block of records read ahead from the spill file
+typedef struct {
+    Fixup *blk;
+    int    n, i;      // records in blk, next one to apply
+    long   next;      // next record of the run to read
+    long   left;      // records of the run not read yet
+} RunCursor;
+
+#define RUN_BLOCK_MAX 256
+
+int stream_mode = 0;
+int stream_budget = 1024;
+
+static FILE     *stream_out;
+static Fixup    *buf;
+static int       buf_count;
+static FILE     *spill;
+static SpillRun *runs;
+static int       run_count, run_cap;
+static long      spill_records;
+
+static int cmp_fixup(const void *a, const void *b) {
+    long x = ((const Fixup *)a)->offset, y = ((const Fixup *)b)->offset;
+    return (x > y) - (x < y);
+}
+
+int stream_begin(FILE *fobj) {
+    stream_out = fobj;
+    buf_count = 0;
+    run_count = 0;
+    spill_records = 0;
+    spill = NULL;
+    if (stream_budget < 1) stream_budget = 1;
+
+    buf = malloc(sizeof(Fixup) * stream_budget);
+    if (!buf) {
+        fprintf(stderr, "ERROR: Cannot allocate fix-up buffer\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int spill_buffer(void) {
+    if (!spill) {
+        spill = tmpfile();
+        if (!spill) {
+            fprintf(stderr, "ERROR: Cannot create fix-up spill file\n");
+            return -1;
+        }
+    }
+    if (run_count == run_cap) {
+        run_cap = run_cap ? run_cap * 2 : 16;
+        runs = realloc(runs, sizeof(SpillRun) * run_cap);
+    }
+
+    qsort(buf, buf_count, sizeof(Fixup), cmp_fixup);
+    fseek(spill, 0, SEEK_END);
+    if (fwrite(buf, sizeof(Fixup), buf_count, spill) != (size_t)buf_count) {
+        fprintf(stderr, "ERROR: Cannot write fix-up spill file\n");
+        return -1;
+    }
+    runs[run_count].start = spill_records;
+    runs[run_count].count = buf_count;
+    run_count++;
+    spill_records += buf_count;
+    buf_count = 0;
+    return 0;
+}
+
+// Called by Pass 1 right before the line holding the operand is written
+int stream_add_fixup(const char *symbol, int expr_idx, int lc, int nbytes) {
+    if (buf_count == stream_budget && spill_buffer() < 0) return -1;
+
+    Fixup *f = &buf[buf_count++];
+    memset(f, 0, sizeof(*f));
+    // Line layout (write_code_line): LC digits, "  ", 2-digit opcode, "  "
+    f->offset = ftell(stream_out) + addr_bytes * 2 + 6;
+    f->lc = lc;
+    f->nbytes = nbytes;
+    f->expr_idx = expr_idx;
+    strncpy(f->symbol, symbol, 9);
+    return 0;
+}
+
+static int patch_object(int fd, const char *text, int n, long offset) {
+#ifdef ASM_HAVE_POSIX
+    return pwrite(fd, text, n, offset) == n ? 0 : -1;
+#else
+    // Offsets come from ftell on the same stream, so fseek accepts them
+    if (fseek(stream_out, offset, SEEK_SET) != 0) return -1;
+    return fwrite(text, 1, n, stream_out) == (size_t)n ? 0 : -1;
+#endif
+}
+
+static int apply_fixup(const Fixup *f, int fd) {
+    int value;
+
+    if (f->expr_idx >= 0) {
+        if (EXPT[f->expr_idx].state != EXPR_DONE) return 0;  // already reported
+        value = EXPT[f->expr_idx].value;
+    } else {
+        value = (f->symbol[0] == '=') ? find_literal_address(f->symbol)
+                                      : find_symbol_address(f->symbol);
+        if (value < 0) {
+            fprintf(stderr, "ERROR: Undefined symbol %s at %X\n", f->symbol, f->lc);
+            return 0;
+        }
+        // Absolute EQU constants are not relocated (see finalize_pass1)
+        if (is_absolute_equ(f->symbol)) remove_dat(f->lc + 1);
+    }
+
+    // Same text as write_code_line: "HH HH ..."
+    char text[16];
+    int n = 0;
+    for (int i = f->nbytes - 1; i >= 0; i--) {
+        n += snprintf(text + n, sizeof(text) - n, (i == f->nbytes - 1) ? "%02X" : " %02X",
+                      (value >> (8 * i)) & 0xFF);
+    }
+    if (patch_object(fd, text, n, f->offset) < 0) {
+        fprintf(stderr, "ERROR: Cannot patch object file at %X\n", f->lc);
+        return -1;
+    }
+    return 0;
+}
+
+// Merges the spill runs and the in-memory buffer by offset and applies
+// every fix-up; call after finalize_pass1
+// Reads the next block of a run; a failed read ends the run
+static int refill_run(RunCursor *c, int block) {
+    c->i = 0;
+    c->n = 0;
+    if (c->left == 0) return 0;
+    long want = c->left < block ? c->left : block;
+    if (fseek(spill, c->next * (long)sizeof(Fixup), SEEK_SET) != 0
+            || (c->n = (int)fread(c->blk, sizeof(Fixup), want, spill)) == 0) {
+        fprintf(stderr, "ERROR: Cannot read fix-up spill file\n");
+        c->n = 0;
+        c->left = 0;
+        return -1;
+    }
+    c->next += c->n;
+    c->left -= c->n;
+    return 0;
+}
+
+int stream_finish(void) {
+    int rc = 0;
+    fflush(stream_out);
+#ifdef ASM_HAVE_POSIX
+    int fd = fileno(stream_out);
+#else
+    int fd = -1;
+#endif
+
+    qsort(buf, buf_count, sizeof(Fixup), cmp_fixup);
+
+    // One cursor per run, each with a block of about stream_budget / runs
+    // records, so the merge reads the spill file a block at a time
+    int block = run_count ? stream_budget / run_count : 1;
+    if (block < 1) block = 1;
+    if (block > RUN_BLOCK_MAX) block = RUN_BLOCK_MAX;
+
+    RunCursor *cur = calloc(run_count + 1, sizeof(RunCursor));
+    Fixup *blocks = malloc(sizeof(Fixup) * ((size_t)run_count * block + 1));
+    int    mem_pos = 0;
+    if (!cur || !blocks) {
+        fprintf(stderr, "ERROR: Cannot allocate fix-up merge buffers\n");
+        free(cur);
+        free(blocks);
+        run_count = 0;
+        buf_count = 0;
+        rc = -1;
+    }
+
+    for (int r = 0; r < run_count; r++) {
+        cur[r].blk = blocks + (size_t)r * block;
+        cur[r].next = runs[r].start;
+        cur[r].left = runs[r].count;
+        if (refill_run(&cur[r], block) < 0) rc = -1;
+    }
+
+    for (;;) {
+        int best = -1;          // run index, or run_count for the buffer
+        long best_off = 0;
+        for (int r = 0; r < run_count; r++) {
+            if (cur[r].i < cur[r].n && (best < 0 || cur[r].blk[cur[r].i].offset < best_off)) {
+                best = r;
+                best_off = cur[r].blk[cur[r].i].offset;
+            }
+        }
+        if (mem_pos < buf_count && (best < 0 || buf[mem_pos].offset < best_off))
+            best = run_count;
+        if (best < 0) break;
+
+        if (best == run_count) {
+            if (apply_fixup(&buf[mem_pos++], fd) < 0) rc = -1;
+            continue;
+        }
+
+        RunCursor *c = &cur[best];
+        if (apply_fixup(&c->blk[c->i++], fd) < 0) rc = -1;
+        if (c->i == c->n && refill_run(c, block) < 0) rc = -1;
+    }
+
+    if (run_count > 0) {
+        printf("Fix-ups: %ld spilled in %d runs, %d in memory\n", spill_records, run_count, buf_count);
+    }
+
+    free(cur);
+    free(blocks);
+    free(buf);
+    free(runs);
+    buf = NULL;
+    runs = NULL;
+    run_cap = 0;
+    if (spill) fclose(spill);
+    spill = NULL;
+    return rc;
+}
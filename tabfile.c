@@ -0,0 +1,313 @@
+#include "asm_common.h"
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+/**
+ * .t file encoding helpers
+ *
+ * Plain format (default):
+ *   DAT            one relocatable address per line
+ *   M sym addr     one line per external use
+ *
+ * Compact format (-c):
+ *   DATV n         n LEB128 varints: first address, then deltas (sorted)
+ *   DATB base n    bitmap, bit i set when base+i is relocatable
+ *   MV sym n       n LEB128 varints: first use address, then deltas
+ *
+ * Line table (-g):
+ *   LINES file n   n entries mapping instructions to source lines. Each
+ *                  entry is one varint (dline << 6) | (size << 3) | gap:
+ *                  dline is the delta from the previous line, size the
+ *                  instruction bytes and gap the bytes between the end of
+ *                  the previous instruction and this one. When gap >= 7 the
+ *                  low bits are 7 and gap follows as a second varint. A
+ *                  typical entry (next instruction on the next line) is a
+ *                  single byte.
+ *
+ * Varint bytes are written as hex, TAB_HEX_PER_LINE bytes per line.
+ * Both formats can be read back with tab_sweep().
+ */
+
+#define TAB_HEX_PER_LINE 32
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int varint_size(unsigned v) {
+    int n = 1;
+    while (v >= 0x80) { v >>= 7; n++; }
+    return n;
+}
+
+// Writes one byte as hex, breaking the line every TAB_HEX_PER_LINE bytes
+static void put_hex_byte(FILE *f, int byte, int *col) {
+    if (*col == TAB_HEX_PER_LINE) {
+        fputc('\n', f);
+        *col = 0;
+    }
+    fprintf(f, "%02X", byte & 0xFF);
+    (*col)++;
+}
+
+static void put_varint(FILE *f, unsigned v, int *col) {
+    while (v >= 0x80) {
+        put_hex_byte(f, (int)(v & 0x7F) | 0x80, col);
+        v >>= 7;
+    }
+    put_hex_byte(f, (int)v, col);
+}
+
+static void put_delta_list(FILE *f, const int *addrs, int n) {
+    int col = 0;
+    int prev = 0;
+    for (int i = 0; i < n; i++) {
+        put_varint(f, (unsigned)(addrs[i] - prev), &col);
+        prev = addrs[i];
+    }
+    fputc('\n', f);
+}
+
+void write_dat_compact(FILE *ftab, int *addrs, int n) {
+    if (n == 0) {
+        fprintf(ftab, "DATV 0\n");
+        return;
+    }
+
+    qsort(addrs, n, sizeof(int), cmp_int);
+
+    int varint_bytes = 0;
+    int prev = 0;
+    for (int i = 0; i < n; i++) {
+        varint_bytes += varint_size((unsigned)(addrs[i] - prev));
+        prev = addrs[i];
+    }
+
+    // Dense tables are cheaper as a bitmap over [first, last]
+    int base = addrs[0];
+    int nbits = addrs[n - 1] - base + 1;
+    int bitmap_bytes = (nbits + 7) / 8;
+
+    if (bitmap_bytes < varint_bytes) {
+        fprintf(ftab, "DATB %X %X\n", base, nbits);
+        int col = 0;
+        int k = 0;
+        for (int b = 0; b < bitmap_bytes; b++) {
+            int byte = 0;
+            while (k < n && addrs[k] - base < (b + 1) * 8) {
+                byte |= 1 << ((addrs[k] - base) & 7);
+                k++;
+            }
+            put_hex_byte(ftab, byte, &col);
+        }
+        fputc('\n', ftab);
+    } else {
+        fprintf(ftab, "DATV %X\n", n);
+        put_delta_list(ftab, addrs, n);
+    }
+}
+
+void write_mrec_compact(FILE *ftab, const char *symbol, int *addrs, int n) {
+    qsort(addrs, n, sizeof(int), cmp_int);
+    fprintf(ftab, "MV %s %X\n", symbol, n);
+    put_delta_list(ftab, addrs, n);
+}
+
+void write_line_table(FILE *ftab, const char *file, const int *addrs, const int *lines,
+                      const int *sizes, int n) {
+    int col = 0;
+    int prev_end = 0, prev_line = 0;
+
+    fprintf(ftab, "LINES %s %X\n", file, n);
+    for (int i = 0; i < n; i++) {
+        unsigned gap = (unsigned)(addrs[i] - prev_end);
+        unsigned head = ((unsigned)(lines[i] - prev_line) << 6) | ((unsigned)sizes[i] << 3);
+        if (gap < 7) {
+            put_varint(ftab, head | gap, &col);
+        } else {
+            put_varint(ftab, head | 7, &col);
+            put_varint(ftab, gap, &col);
+        }
+        prev_end = addrs[i] + sizes[i];
+        prev_line = lines[i];
+    }
+    fputc('\n', ftab);
+}
+
+// --- Reader ---
+
+static int get_hex_byte(FILE *f) {
+    int c;
+    do { c = fgetc(f); } while (c != EOF && isspace(c));
+    if (c == EOF) return -1;
+    int d = fgetc(f);
+    if (d == EOF) return -1;
+    char s[3] = { (char)c, (char)d, '\0' };
+    return (int)strtol(s, NULL, 16);
+}
+
+static int get_varint(FILE *f, unsigned *out) {
+    unsigned v = 0;
+    int shift = 0;
+    for (;;) {
+        int b = get_hex_byte(f);
+        if (b < 0) return 0;
+        v |= (unsigned)(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+        shift += 7;
+    }
+    *out = v;
+    return 1;
+}
+
+// Reads a delta list and reports each address in ascending order
+static int sweep_delta_list(FILE *f, char code, const char *symbol, int n,
+                            TabRecordFn fn, void *ctx) {
+    int addr = 0;
+    for (int i = 0; i < n; i++) {
+        unsigned d;
+        if (!get_varint(f, &d)) return -1;
+        addr += (int)d;
+        fn(code, symbol, addr, 0, ctx);
+    }
+    return 0;
+}
+
+static int get_line_entry(FILE *f, unsigned *gap, unsigned *size, unsigned *dline) {
+    unsigned v;
+    if (!get_varint(f, &v)) return 0;
+    *dline = v >> 6;
+    *size = (v >> 3) & 7;
+    *gap = v & 7;
+    if (*gap == 7 && !get_varint(f, gap)) return 0;
+    return 1;
+}
+
+int tab_sweep(FILE *ftab, TabRecordFn fn, void *ctx) {
+    char line[256];
+    int in_dat = 0;
+
+    while (fgets(line, sizeof(line), ftab)) {
+        char tag[8] = {0};
+        char sym[32] = {0};
+        int a = 0, b = 0;
+
+        if (sscanf(line, "%7s", tag) != 1) continue;
+
+        if (strcmp(tag, "DAT") == 0) { in_dat = 1; continue; }
+        if (strcmp(tag, "HDRM") == 0) { in_dat = 0; continue; }
+
+        if (strcmp(tag, "DATV") == 0) {
+            in_dat = 0;
+            if (sscanf(line, "%*s %x", &a) != 1) return -1;
+            if (sweep_delta_list(ftab, 'A', NULL, a, fn, ctx) < 0) return -1;
+            continue;
+        }
+        if (strcmp(tag, "DATB") == 0) {
+            in_dat = 0;
+            if (sscanf(line, "%*s %x %x", &a, &b) != 2) return -1;
+            for (int i = 0; i < (b + 7) / 8; i++) {
+                int byte = get_hex_byte(ftab);
+                if (byte < 0) return -1;
+                for (int bit = 0; bit < 8; bit++) {
+                    if (byte & (1 << bit)) fn('A', NULL, a + i * 8 + bit, 0, ctx);
+                }
+            }
+            continue;
+        }
+        if (strcmp(tag, "LINES") == 0) {
+            // Not a relocation record: skip (read with tab_read_lines)
+            unsigned gap, size, dline;
+            if (sscanf(line, "%*s %*s %x", &a) != 1) return -1;
+            for (int i = 0; i < a; i++)
+                if (!get_line_entry(ftab, &gap, &size, &dline)) return -1;
+            continue;
+        }
+        if (strcmp(tag, "MV") == 0) {
+            if (sscanf(line, "%*s %9s %x", sym, &a) != 2) return -1;
+            if (sweep_delta_list(ftab, 'M', sym, a, fn, ctx) < 0) return -1;
+            continue;
+        }
+
+        if (in_dat) {
+            if (sscanf(line, "%x", &a) == 1) fn('A', NULL, a, 0, ctx);
+            continue;
+        }
+
+        switch (tag[0]) {
+        case 'H': {
+            int bits = 0;
+            int n = sscanf(line, "%*s %9s %x %x W%d", sym, &a, &b, &bits);
+            if (n >= 3) fn('H', sym, a, b, ctx);
+            if (n == 4) fn('W', NULL, bits, 0, ctx);
+            break;
+        }
+        case 'D':
+        case 'M':
+            if (sscanf(line, "%*s %9s %x", sym, &a) == 2) fn(tag[0], sym, a, 0, ctx);
+            break;
+        case 'R':
+            if (sscanf(line, "%*s %9s", sym) == 1) fn('R', sym, 0, 0, ctx);
+            break;
+        }
+    }
+    return 0;
+}
+
+// --- Line table ---
+
+int tab_read_lines(FILE *ftab, LineTable *lt) {
+    char line[256];
+    memset(lt, 0, sizeof(*lt));
+
+    while (fgets(line, sizeof(line), ftab)) {
+        int n = 0;
+        if (strncmp(line, "LINES ", 6) != 0) continue;
+        if (sscanf(line, "%*s %63s %x", lt->file, &n) != 2) return -1;
+
+        lt->address = malloc(sizeof(int) * (n > 0 ? n : 1));
+        lt->line = malloc(sizeof(int) * (n > 0 ? n : 1));
+        lt->size = malloc(sizeof(int) * (n > 0 ? n : 1));
+        if (!lt->address || !lt->line || !lt->size) return -1;
+
+        int end = 0, ln = 0;
+        for (int i = 0; i < n; i++) {
+            unsigned gap, size, dline;
+            if (!get_line_entry(ftab, &gap, &size, &dline)) return -1;
+            ln += (int)dline;
+            lt->address[i] = end + (int)gap;
+            lt->line[i] = ln;
+            lt->size[i] = (int)size;
+            end = lt->address[i] + (int)size;
+            lt->count++;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+// Source line of the instruction covering address, or -1 when no
+// instruction does (data, literal pools, gaps)
+int line_table_lookup(const LineTable *lt, int address) {
+    int lo = 0, hi = lt->count - 1, found = -1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (lt->address[mid] <= address) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (found < 0 || address >= lt->address[found] + lt->size[found]) return -1;
+    return lt->line[found];
+}
+
+void line_table_free(LineTable *lt) {
+    free(lt->address);
+    free(lt->line);
+    free(lt->size);
+    memset(lt, 0, sizeof(*lt));
+}